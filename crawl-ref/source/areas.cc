@@ -21,6 +21,8 @@
 #include "losglobal.h"
 #include "message.h"
 #include "mon-behv.h"
+#include "mon-info.h"
+#include "mon-util.h"
 #include "religion.h"
 #include "stepdown.h"
 #include "terrain.h"
@@ -52,17 +54,54 @@ struct area_centre
     explicit area_centre (area_centre_type t, coord_def c, int r) : type(t), centre(c), radius(r) { }
 };
 
+static const int NUM_AREAPROPS = 11;
+
+// Everything a single actor (or, for MID_NOBODY, the level's sunlight)
+// has added to the grid, so that it can be taken back out when only that
+// actor has moved.
+struct area_source
+{
+    vector<area_centre> centres;
+    vector<pair<coord_def, areaprop>> cells;
+};
+
 typedef FixedArray<areaprops, GXM, GYM> propgrid_t;
+typedef FixedArray<unsigned short, GXM, GYM> refgrid_t;
 
-static vector<area_centre> _agrid_centres;
+static map<mid_t, area_source> _agrid_sources;
 
 static propgrid_t _agrid;
+// How many sources cover each cell, per areaprop bit.
+static refgrid_t _agrid_refs[NUM_AREAPROPS];
 static bool _agrid_valid = false;
+// Whether the next update has to rebuild everything, rather than just
+// redo the actors in _agrid_moved.
+static bool _agrid_stale = true;
+static vector<mid_t> _agrid_moved;
 static bool no_areas = false;
 
-static void _set_agrid_flag(const coord_def& p, areaprop f)
+static int _areaprop_bit(areaprop f)
+{
+    int bit = 0;
+    for (unsigned int v = static_cast<unsigned int>(f); v > 1; v >>= 1)
+        ++bit;
+    ASSERT(bit < NUM_AREAPROPS);
+    return bit;
+}
+
+static void _set_agrid_flag(area_source &src, const coord_def& p, areaprop f)
 {
-    _agrid(p) |= f;
+    src.cells.emplace_back(p, f);
+    if (!_agrid_refs[_areaprop_bit(f)](p)++)
+        _agrid(p) |= f;
+}
+
+static void _clear_agrid_flag(const coord_def& p, areaprop f)
+{
+    unsigned short &refs = _agrid_refs[_areaprop_bit(f)](p);
+    ASSERT(refs > 0);
+    if (!--refs)
+        _agrid(p) &= ~areaprops(f);
 }
 
 static bool _check_agrid_flag(const coord_def& p, areaprop f)
@@ -73,8 +112,12 @@ static bool _check_agrid_flag(const coord_def& p, areaprop f)
 void invalidate_agrid(bool recheck_new)
 {
     _agrid_valid = false;
+    _agrid_stale = true;
     if (recheck_new)
         no_areas = false;
+    // Halos, silence and so on show up in monster_info, and LOS changes
+    // (which also come through here) can change its fire_blocker.
+    invalidate_monster_info_cache();
 }
 
 void areas_actor_moved(const actor* act, const coord_def& oldpos)
@@ -85,69 +128,153 @@ void areas_actor_moved(const actor* act, const coord_def& oldpos)
          || act->liquefying_radius() > -1 || act->umbra_radius() > -1))
     {
         // Not necessarily new, but certainly potentially interesting.
-        invalidate_agrid(true);
+        if (you.entering_level || _agrid_stale)
+            invalidate_agrid(true);
+        else
+        {
+            // Only this actor's areas have moved; redo just those.
+            _agrid_valid = false;
+            no_areas = false;
+            if (find(_agrid_moved.begin(), _agrid_moved.end(), act->mid)
+                == _agrid_moved.end())
+            {
+                _agrid_moved.push_back(act->mid);
+            }
+            invalidate_monster_info_cache();
+        }
+    }
+}
+
+static void _player_areas(area_source &src)
+{
+    if (player_has_orb() && !you.pos().origin())
+    {
+        const int r = 2;
+        src.centres.emplace_back(area_centre_type::orb, you.pos(), r);
+        for (radius_iterator ri(you.pos(), r, C_SQUARE, LOS_DEFAULT); ri; ++ri)
+            _set_agrid_flag(src, *ri, areaprop::orb);
+    }
+
+    if (you.duration[DUR_QUAD_DAMAGE])
+    {
+        const int r = 2;
+        src.centres.emplace_back(area_centre_type::quad, you.pos(), r);
+        for (radius_iterator ri(you.pos(), r, C_SQUARE);
+             ri; ++ri)
+        {
+            if (cell_see_cell(you.pos(), *ri, LOS_DEFAULT))
+                _set_agrid_flag(src, *ri, areaprop::quad);
+        }
+    }
+
+    if (you.duration[DUR_DISJUNCTION])
+    {
+        const int r = 4;
+        src.centres.emplace_back(area_centre_type::disjunction,
+                                 you.pos(), r);
+        for (radius_iterator ri(you.pos(), r, C_SQUARE);
+             ri; ++ri)
+        {
+            if (cell_see_cell(you.pos(), *ri, LOS_DEFAULT))
+                _set_agrid_flag(src, *ri, areaprop::disjunction);
+        }
     }
 }
 
 static void _actor_areas(actor *a)
 {
+    area_source src;
     int r;
 
     if ((r = a->silence_radius()) >= 0)
     {
-        _agrid_centres.emplace_back(area_centre_type::silence, a->pos(), r);
+        src.centres.emplace_back(area_centre_type::silence, a->pos(), r);
 
         for (radius_iterator ri(a->pos(), r, C_SQUARE); ri; ++ri)
-            _set_agrid_flag(*ri, areaprop::silence);
-        no_areas = false;
+            _set_agrid_flag(src, *ri, areaprop::silence);
     }
 
     if ((r = a->halo_radius()) >= 0)
     {
-        _agrid_centres.emplace_back(area_centre_type::halo, a->pos(), r);
+        src.centres.emplace_back(area_centre_type::halo, a->pos(), r);
 
         for (radius_iterator ri(a->pos(), r, C_SQUARE, LOS_DEFAULT); ri; ++ri)
-            _set_agrid_flag(*ri, areaprop::halo);
-        no_areas = false;
+            _set_agrid_flag(src, *ri, areaprop::halo);
     }
 
     if ((r = a->liquefying_radius()) >= 0)
     {
-        _agrid_centres.emplace_back(area_centre_type::liquid, a->pos(), r);
+        src.centres.emplace_back(area_centre_type::liquid, a->pos(), r);
 
         for (radius_iterator ri(a->pos(), r, C_SQUARE, LOS_SOLID); ri; ++ri)
         {
             dungeon_feature_type f = grd(*ri);
 
-            _set_agrid_flag(*ri, areaprop::liquid);
+            _set_agrid_flag(src, *ri, areaprop::liquid);
 
             if (feat_has_solid_floor(f) && !feat_is_water(f))
-                _set_agrid_flag(*ri, areaprop::actual_liquid);
+                _set_agrid_flag(src, *ri, areaprop::actual_liquid);
         }
-        no_areas = false;
     }
 
     if ((r = a->umbra_radius()) >= 0)
     {
-        _agrid_centres.emplace_back(area_centre_type::umbra, a->pos(), r);
+        src.centres.emplace_back(area_centre_type::umbra, a->pos(), r);
 
         for (radius_iterator ri(a->pos(), r, C_SQUARE, LOS_DEFAULT); ri; ++ri)
-            _set_agrid_flag(*ri, areaprop::umbra);
+            _set_agrid_flag(src, *ri, areaprop::umbra);
+    }
+
+    if (a->is_player())
+        _player_areas(src);
+
+    if (!src.cells.empty() || !src.centres.empty())
+    {
+        _agrid_sources[a->mid] = move(src);
         no_areas = false;
     }
 }
 
+static void _remove_actor_areas(mid_t mid)
+{
+    area_source *src = map_find(_agrid_sources, mid);
+    if (!src)
+        return;
+
+    for (const auto &cell : src->cells)
+        _clear_agrid_flag(cell.first, cell.second);
+    _agrid_sources.erase(mid);
+}
+
 /**
  * Update the area grid cache.
  *
  * Updates the _agrid FixedArray of grid information flags using the
- * areaprop types.
+ * areaprop types. If only some actors have moved since the last update,
+ * just their contributions are taken out and put back in.
  */
 static void _update_agrid()
 {
     // sanitize rng in case this gets indirectly called by the builder.
     rng::generator gameplay(rng::GAMEPLAY);
 
+    if (!_agrid_stale)
+    {
+        for (mid_t mid : _agrid_moved)
+        {
+            _remove_actor_areas(mid);
+            actor *a = actor_by_mid(mid);
+            if (a && a->alive())
+                _actor_areas(a);
+        }
+        _agrid_moved.clear();
+        _agrid_valid = true;
+        return;
+    }
+
+    _agrid_moved.clear();
+    _agrid_stale = false;
+
     if (no_areas)
     {
         _agrid_valid = true;
@@ -155,7 +282,9 @@ static void _update_agrid()
     }
 
     _agrid.init(areaprops());
-    _agrid_centres.clear();
+    for (refgrid_t &refs : _agrid_refs)
+        refs.init(0);
+    _agrid_sources.clear();
 
     no_areas = true;
 
@@ -163,46 +292,11 @@ static void _update_agrid()
     for (monster_iterator mi; mi; ++mi)
         _actor_areas(*mi);
 
-    if (player_has_orb() && !you.pos().origin())
-    {
-        const int r = 2;
-        _agrid_centres.emplace_back(area_centre_type::orb, you.pos(), r);
-        for (radius_iterator ri(you.pos(), r, C_SQUARE, LOS_DEFAULT); ri; ++ri)
-            _set_agrid_flag(*ri, areaprop::orb);
-        no_areas = false;
-    }
-
-    if (you.duration[DUR_QUAD_DAMAGE])
-    {
-        const int r = 2;
-        _agrid_centres.emplace_back(area_centre_type::quad, you.pos(), r);
-        for (radius_iterator ri(you.pos(), r, C_SQUARE);
-             ri; ++ri)
-        {
-            if (cell_see_cell(you.pos(), *ri, LOS_DEFAULT))
-                _set_agrid_flag(*ri, areaprop::quad);
-        }
-        no_areas = false;
-    }
-
-    if (you.duration[DUR_DISJUNCTION])
-    {
-        const int r = 4;
-        _agrid_centres.emplace_back(area_centre_type::disjunction,
-                                    you.pos(), r);
-        for (radius_iterator ri(you.pos(), r, C_SQUARE);
-             ri; ++ri)
-        {
-            if (cell_see_cell(you.pos(), *ri, LOS_DEFAULT))
-                _set_agrid_flag(*ri, areaprop::disjunction);
-        }
-        no_areas = false;
-    }
-
     if (!env.sunlight.empty())
     {
+        area_source &src = _agrid_sources[MID_NOBODY];
         for (const auto &entry : env.sunlight)
-            _set_agrid_flag(entry.first, areaprop::halo);
+            _set_agrid_flag(src, entry.first, areaprop::halo);
         no_areas = false;
     }
 
@@ -244,9 +338,6 @@ coord_def find_centre_for(const coord_def& f, area_centre_type at)
     if (!_agrid(f))
         return coord_def(-1, -1);
 
-    if (_agrid_centres.empty())
-        return coord_def(-1, -1);
-
     coord_def possible = coord_def(-1, -1);
     int dist = 0;
 
@@ -258,21 +349,22 @@ coord_def find_centre_for(const coord_def& f, area_centre_type at)
     // on the off chance that there is an error, assert here
     ASSERT(at != area_centre_type::none);
 
-    for (const area_centre &a : _agrid_centres)
-    {
-        if (a.type != at)
-            continue;
+    for (const auto &entry : _agrid_sources)
+        for (const area_centre &a : entry.second.centres)
+        {
+            if (a.type != at)
+                continue;
 
-        if (a.centre == f)
-            return f;
+            if (a.centre == f)
+                return f;
 
-        int d = grid_distance(a.centre, f);
-        if (d <= a.radius && (d <= dist || dist == 0))
-        {
-            possible = a.centre;
-            dist = d;
+            int d = grid_distance(a.centre, f);
+            if (d <= a.radius && (d <= dist || dist == 0))
+            {
+                possible = a.centre;
+                dist = d;
+            }
         }
-    }
 
     return possible;
 }
@@ -1052,41 +1052,79 @@ void artefact_properties(const item_def &item,
     artefact_properties(item, proprt, known);
 }
 
-int artefact_property(const item_def &item, artefact_prop_type prop,
-                      bool &_known)
+/**
+ * Read a single property of an artefact, without unpacking all the others.
+ *
+ * @param item      The artefact.
+ * @param prop      The property to read.
+ * @param known[out] If non-null, set to whether the player knows about it.
+ * @return          The property's value, as artefact_properties() would
+ *                  report it.
+ */
+static int _artefact_property(const item_def &item, artefact_prop_type prop,
+                              bool *known)
 {
-    artefact_properties_t  proprt;
-    artefact_known_props_t known;
-    proprt.init(0);
-    known.init(0);
+    ASSERT(is_artefact(item));
+    ASSERT_RANGE(prop, 0, ART_PROPERTIES);
 
-    artefact_properties(item, proprt, known);
+    // Keep the keys around, rather than building a string per lookup.
+    static const string known_key = KNOWN_PROPS_KEY;
+    static const string props_key = ARTEFACT_PROPS_KEY;
+
+    const auto known_it = item.props.find(known_key);
+    if (known_it == item.props.end())
+    {
+        if (known)
+            *known = false;
+        return 0;
+    }
 
-    _known = known[prop];
+    if (known)
+    {
+        if (item_ident(item, ISFLAG_KNOW_PROPERTIES))
+            *known = true;
+        else
+        {
+            const CrawlVector &known_vec = known_it->second.get_vector();
+            ASSERT(known_vec.get_type() == SV_BOOL);
+            ASSERT(known_vec.size()     == ART_PROPERTIES);
+            *known = known_vec[prop].get_bool();
+        }
+    }
 
+    const auto props_it = item.props.find(props_key);
+    if (props_it != item.props.end())
+    {
+        const CrawlVector &rap_vec = props_it->second.get_vector();
+        ASSERT(rap_vec.get_type() == SV_SHORT);
+        ASSERT(rap_vec.size()     == ART_PROPERTIES);
+        return rap_vec[prop].get_short();
+    }
+    else if (is_unrandom_artefact(item))
+        return static_cast<short>(_seekunrandart(item)->prpty[prop]);
+
+    artefact_properties_t proprt;
+    proprt.init(0);
+    _get_randart_properties(item, proprt);
     return proprt[prop];
 }
 
-int artefact_property(const item_def &item, artefact_prop_type prop)
+int artefact_property(const item_def &item, artefact_prop_type prop,
+                      bool &_known)
 {
-    bool known;
+    return _artefact_property(item, prop, &_known);
+}
 
-    return artefact_property(item, prop, known);
+int artefact_property(const item_def &item, artefact_prop_type prop)
+{
+    return _artefact_property(item, prop, nullptr);
 }
 
 int artefact_known_property(const item_def &item, artefact_prop_type prop)
 {
-    artefact_properties_t  proprt;
-    artefact_known_props_t known;
-    proprt.init(0);
-    known.init(0);
-
-    artefact_properties(item, proprt, known);
-
-    if (known[prop])
-        return proprt[prop];
-    else
-        return 0;
+    bool known;
+    const int value = _artefact_property(item, prop, &known);
+    return known ? value : 0;
 }
 
 static int _artefact_num_props(const artefact_properties_t &proprt)
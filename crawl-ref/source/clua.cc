@@ -56,9 +56,14 @@ CLua::CLua(bool managed)
       throttle_sleep_ms(0), throttle_sleep_start(2),
       throttle_sleep_end(800), n_throttle_sleeps(0), mixed_call_depth(0),
       lua_call_depth(0), max_mixed_call_depth(8),
-      max_lua_call_depth(100), memory_used(0),
+      max_lua_call_depth(100), memory_used(0), alloc_stats(),
       _state(nullptr), sourced_files(), uniqindex(0)
 {
+    for (int i = 0; i < ALLOC_POOL_CLASSES; ++i)
+    {
+        free_blocks[i] = nullptr;
+        n_free_blocks[i] = 0;
+    }
 }
 
 CLua::~CLua()
@@ -72,6 +77,7 @@ CLua::~CLua()
     shutting_down = true;
     if (_state)
         lua_close(_state);
+    release_free_blocks();
 }
 
 lua_State *CLua::state()
@@ -743,8 +749,9 @@ void CLua::init_lua()
 # endif
     _state = luaL_newstate();
 #else
-    // Throttle memory usage in managed (clua) VMs
-    _state = managed_vm? lua_newstate(_clua_allocator, this) : luaL_newstate();
+    // Throttle memory usage in managed (clua) VMs; all VMs get the
+    // allocation stats and the small-block pool.
+    _state = lua_newstate(_clua_allocator, this);
 #endif
     if (!_state)
         end(1, false, "Unable to create Lua state.");
@@ -1101,22 +1108,110 @@ static void *_clua_allocator(void *ud, void *ptr, size_t osize, size_t nsize)
     CLua *cl = static_cast<CLua *>(ud);
     cl->memory_used += nsize - osize;
 
-    if (nsize > osize && cl->memory_used >= CLUA_MAX_MEMORY_USE * 1024
+    if (cl->managed_vm && nsize > osize
+        && cl->memory_used >= CLUA_MAX_MEMORY_USE * 1024
         && cl->mixed_call_depth)
     {
         return nullptr;
     }
 
+    if (nsize > osize)
+    {
+        ++cl->alloc_stats.allocs;
+        cl->alloc_stats.bytes += nsize;
+        cl->alloc_stats.peak = max(cl->alloc_stats.peak, cl->memory_used);
+    }
+
     if (!nsize)
     {
-        free(ptr);
+        ++cl->alloc_stats.frees;
+        cl->free_block(ptr, osize);
         return nullptr;
     }
     else
-        return realloc(ptr, nsize);
+        return cl->resize_block(ptr, osize, nsize);
 }
 #endif
 
+// Lua churns through lots of small, short-lived blocks (strings, tables,
+// closures), especially in the dungeon builder; keeping freed ones around
+// by size saves most of the malloc/free traffic.
+static int _alloc_pool_class(size_t size, int step, int classes)
+{
+    return size && size <= (size_t) step * classes ? (size - 1) / step : -1;
+}
+
+void *CLua::take_block(int size_class)
+{
+    if (void *block = free_blocks[size_class])
+    {
+        free_blocks[size_class] = *static_cast<void **>(block);
+        --n_free_blocks[size_class];
+        ++alloc_stats.pooled;
+        return block;
+    }
+    return malloc((size_class + 1) * ALLOC_POOL_STEP);
+}
+
+void CLua::free_block(void *ptr, size_t osize)
+{
+    if (!ptr)
+        return;
+
+    const int size_class = _alloc_pool_class(osize, ALLOC_POOL_STEP,
+                                             ALLOC_POOL_CLASSES);
+    if (size_class < 0 || n_free_blocks[size_class] >= ALLOC_POOL_MAX_FREE)
+    {
+        free(ptr);
+        return;
+    }
+    *static_cast<void **>(ptr) = free_blocks[size_class];
+    free_blocks[size_class] = ptr;
+    ++n_free_blocks[size_class];
+}
+
+// Same contract as realloc, except that Lua tells us the old size.
+void *CLua::resize_block(void *ptr, size_t osize, size_t nsize)
+{
+    const int oclass = ptr ? _alloc_pool_class(osize, ALLOC_POOL_STEP,
+                                               ALLOC_POOL_CLASSES)
+                           : -1;
+    const int nclass = _alloc_pool_class(nsize, ALLOC_POOL_STEP,
+                                         ALLOC_POOL_CLASSES);
+    if (oclass < 0 && nclass < 0)
+        return realloc(ptr, nsize);
+    if (ptr && oclass == nclass)
+        return ptr;
+
+    void *block = nclass >= 0 ? take_block(nclass) : malloc(nsize);
+    if (block && ptr)
+    {
+        memcpy(block, ptr, min(osize, nsize));
+        free_block(ptr, osize);
+    }
+    return block;
+}
+
+// Hand the spare blocks back to the system, e.g. once a level is built.
+void CLua::release_free_blocks()
+{
+    for (int i = 0; i < ALLOC_POOL_CLASSES; ++i)
+    {
+        while (void *block = free_blocks[i])
+        {
+            free_blocks[i] = *static_cast<void **>(block);
+            free(block);
+        }
+        n_free_blocks[i] = 0;
+    }
+}
+
+void CLua::reset_alloc_stats()
+{
+    alloc_stats = lua_alloc_stats();
+    alloc_stats.peak = memory_used;
+}
+
 static void _clua_throttle_hook(lua_State *ls, lua_Debug *dbg)
 {
     CLua *lua = lua_call_throttle::find_clua(ls);
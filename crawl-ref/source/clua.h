@@ -83,6 +83,17 @@ private:
     void cleanup();
 };
 
+// Counters kept by the CLua allocator. They stay at zero in builds that
+// cannot use a custom allocator (64-bit LuaJIT).
+struct lua_alloc_stats
+{
+    unsigned long long allocs; // Calls that allocated or grew a block.
+    unsigned long long frees;  // Calls that released a block.
+    unsigned long long bytes;  // Total bytes handed out by those allocs.
+    unsigned long long pooled; // Allocs served from the spare block lists.
+    long peak;                 // Highest memory_used seen.
+};
+
 class CLua
 {
 public:
@@ -144,6 +155,12 @@ public:
 
     void print_stack();
 
+    // Small-block pool behind the allocator; see _clua_allocator().
+    void *resize_block(void *ptr, size_t osize, size_t nsize);
+    void free_block(void *ptr, size_t osize);
+    void release_free_blocks();
+    void reset_alloc_stats();
+
 public:
     string error;
 
@@ -161,9 +178,22 @@ public:
     int max_lua_call_depth;
 
     long memory_used;
+    lua_alloc_stats alloc_stats;
 
     static const int MAX_THROTTLE_SLEEPS = 100;
 
+private:
+    // Blocks of up to ALLOC_POOL_CLASSES * ALLOC_POOL_STEP bytes are
+    // rounded up to a multiple of ALLOC_POOL_STEP, and freed ones are kept
+    // on a list per size (at most ALLOC_POOL_MAX_FREE each) for reuse.
+    static const int ALLOC_POOL_STEP = 16;
+    static const int ALLOC_POOL_CLASSES = 16;
+    static const int ALLOC_POOL_MAX_FREE = 1024;
+    void *free_blocks[ALLOC_POOL_CLASSES];
+    int n_free_blocks[ALLOC_POOL_CLASSES];
+
+    void *take_block(int size_class);
+
 private:
     lua_State *_state;
     typedef set<string> sfset;
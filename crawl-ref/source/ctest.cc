@@ -18,6 +18,7 @@
 #include "ctest.h"
 
 #include <algorithm>
+#include <chrono>
 #include <vector>
 
 #include "clua.h"
@@ -29,6 +30,8 @@
 #include "files.h"
 #include "item-name.h"
 #include "jobs.h"
+#include "json.h"
+#include "json-wrapper.h"
 #include "libutil.h"
 #include "mapdef.h"
 #include "maps.h"
@@ -39,6 +42,7 @@
 #include "ng-init.h"
 #include "state.h"
 #include "stringutil.h"
+#include "syscalls.h"
 #include "xom.h"
 
 static const string test_dir = "test";
@@ -51,11 +55,34 @@ static int nsuccess = 0;
 typedef pair<string, string> file_error;
 static vector<file_error> failures;
 
+// Perf mode (-perf [N]) runs each selected Lua test N times and reports
+// timings against the baselines in test/perf-baseline.json, which has
+// the same shape as the report written to perf-report.json:
+//   { "tolerance": 0.25, "tests": { "los.lua": { "wall_ms": 120 } } }
+// A test may override the global tolerance with its own "tolerance".
+static const string perf_baseline_file = "perf-baseline.json";
+static const string perf_report_file = "perf-report.json";
+static const double perf_default_tolerance = 0.25;
+
+struct perf_result
+{
+    vector<double> wall_ms; // One sample per run.
+    double gc_ms = 0;       // Full collection after the last run.
+    int lua_kb_start = 0;   // Lua heap before the first run.
+    int lua_kb_end = 0;     // Lua heap after the last run, before the GC.
+    int lua_kb_live = 0;    // Lua heap left once the GC has run.
+    unsigned long long lua_allocs = 0; // Lua allocator calls, all runs.
+};
+
+typedef vector<pair<string, perf_result>> perf_results;
+static perf_results perf;
+
 static void _reset_test_data()
 {
     ntests = 0;
     nsuccess = 0;
     failures.clear();
+    perf.clear();
     you.your_name = "Superbug99";
     you.species = SP_HUMAN;
     you.char_class = JOB_FIGHTER;
@@ -132,11 +159,154 @@ static void run_test(const string &file)
     flush_prev_message();
 
     const string path(catpath(crawl_state.script? script_dir : test_dir, file));
-    dlua.execfile(path.c_str(), true, false);
-    if (dlua.error.empty())
-        ++nsuccess;
-    else
-        failures.emplace_back(file, dlua.error);
+    if (crawl_state.test_perf_runs <= 0)
+    {
+        dlua.execfile(path.c_str(), true, false);
+        if (dlua.error.empty())
+            ++nsuccess;
+        else
+            failures.emplace_back(file, dlua.error);
+        return;
+    }
+
+    typedef chrono::steady_clock clock;
+    perf_result result;
+    lua_gc(dlua, LUA_GCCOLLECT, 0);
+    result.lua_kb_start = lua_gc(dlua, LUA_GCCOUNT, 0);
+    const unsigned long long allocs_start = dlua.alloc_stats.allocs;
+    for (int run = 0; run < crawl_state.test_perf_runs; ++run)
+    {
+        const auto start = clock::now();
+        dlua.execfile(path.c_str(), true, false);
+        const chrono::duration<double, milli> elapsed = clock::now() - start;
+        if (!dlua.error.empty())
+        {
+            failures.emplace_back(file, dlua.error);
+            return;
+        }
+        result.wall_ms.push_back(elapsed.count());
+    }
+    result.lua_kb_end = lua_gc(dlua, LUA_GCCOUNT, 0);
+    result.lua_allocs = dlua.alloc_stats.allocs - allocs_start;
+
+    const auto gc_start = clock::now();
+    lua_gc(dlua, LUA_GCCOLLECT, 0);
+    const chrono::duration<double, milli> gc_time = clock::now() - gc_start;
+    result.gc_ms = gc_time.count();
+    result.lua_kb_live = lua_gc(dlua, LUA_GCCOUNT, 0);
+
+    ++nsuccess;
+    perf.emplace_back(file, result);
+}
+
+static string _read_perf_file(const string &path)
+{
+    FILE *f = fopen_u(path.c_str(), "r");
+    if (!f)
+        return "";
+
+    string text;
+    char buf[4096];
+    size_t got;
+    while ((got = fread(buf, 1, sizeof(buf), f)) > 0)
+        text.append(buf, got);
+    fclose(f);
+    return text;
+}
+
+static double _perf_number(JsonNode *object, const char *key, double def)
+{
+    JsonNode *n = object ? json_find_member(object, key) : nullptr;
+    return n && n->tag == JSON_NUMBER ? n->number_ : def;
+}
+
+// Write perf-report.json, and turn any test slower than its baseline
+// allowance into a failure. The minimum of the runs is compared, since
+// it is the sample least disturbed by whatever else the machine is doing.
+static void _write_perf_report()
+{
+    const string text = _read_perf_file(catpath(test_dir, perf_baseline_file));
+    JsonWrapper baseline(text.empty() ? nullptr : json_decode(text.c_str()));
+    if (!text.empty() && (!baseline.node || baseline->tag != JSON_OBJECT))
+    {
+        failures.emplace_back(perf_baseline_file, "malformed baseline");
+        return;
+    }
+
+    const double tolerance = _perf_number(baseline.node, "tolerance",
+                                          perf_default_tolerance);
+    JsonNode *base_tests = baseline.node
+                           ? json_find_member(baseline.node, "tests")
+                           : nullptr;
+
+    JsonWrapper report(json_mkobject());
+    json_append_member(report.node, "runs",
+                       json_mknumber(crawl_state.test_perf_runs));
+    json_append_member(report.node, "tolerance", json_mknumber(tolerance));
+    JsonNode *tests = json_mkobject();
+    json_append_member(report.node, "tests", tests);
+
+    for (const auto &entry : perf)
+    {
+        const string &name = entry.first;
+        const perf_result &result = entry.second;
+
+        double total = 0;
+        for (double ms : result.wall_ms)
+            total += ms;
+        const double min_ms = *min_element(result.wall_ms.begin(),
+                                           result.wall_ms.end());
+        const double max_ms = *max_element(result.wall_ms.begin(),
+                                           result.wall_ms.end());
+
+        JsonNode *test = json_mkobject();
+        json_append_member(tests, name.c_str(), test);
+        json_append_member(test, "wall_ms", json_mknumber(min_ms));
+        json_append_member(test, "wall_ms_mean",
+                           json_mknumber(total / result.wall_ms.size()));
+        json_append_member(test, "wall_ms_max", json_mknumber(max_ms));
+        json_append_member(test, "gc_ms", json_mknumber(result.gc_ms));
+        json_append_member(test, "lua_allocs",
+                           json_mknumber(result.lua_allocs
+                                         / result.wall_ms.size()));
+        json_append_member(test, "lua_kb_growth",
+                           json_mknumber(result.lua_kb_end
+                                         - result.lua_kb_start));
+        json_append_member(test, "lua_kb_retained",
+                           json_mknumber(result.lua_kb_live
+                                         - result.lua_kb_start));
+
+        JsonNode *base = base_tests ? json_find_member(base_tests, name.c_str())
+                                    : nullptr;
+        const double base_ms = _perf_number(base, "wall_ms", -1);
+        if (base_ms < 0)
+            continue;
+
+        const double allowed = base_ms
+                               * (1 + _perf_number(base, "tolerance",
+                                                   tolerance));
+        json_append_member(test, "baseline_ms", json_mknumber(base_ms));
+        json_append_member(test, "regressed",
+                           json_mkbool(min_ms > allowed));
+        if (min_ms > allowed)
+        {
+            failures.emplace_back(name,
+                make_stringf("perf regression: %.1fms, baseline %.1fms "
+                             "(allowed %.1fms)", min_ms, base_ms, allowed));
+        }
+    }
+
+    FILE *f = fopen_u(perf_report_file.c_str(), "w");
+    if (!f)
+    {
+        failures.emplace_back(perf_report_file, "could not write report");
+        return;
+    }
+    fprintf(f, "%s\n", report.to_string().c_str());
+    fclose(f);
+    fprintf(stderr, "Wrote %s (%u tests, %d runs each).\n",
+            perf_report_file.c_str(), (unsigned int)perf.size(),
+            crawl_state.test_perf_runs);
 }
 
 static bool _has_test(const string& test)
@@ -184,15 +354,19 @@ void run_tests()
 
     _init_test_bindings();
 
-    _run_test("makeitem", makeitem_tests);
-    _run_test("mon-pick", debug_monpick);
-    _run_test("mon-data", debug_mondata);
-    _run_test("mon-spell", debug_monspells);
-    _run_test("coordit", coordit_tests);
-    _run_test("makename", make_name_tests);
-    _run_test("job-data", debug_jobdata);
-    _run_test("mon-bands", debug_bands);
-    _run_test("xom-data", validate_xom_events);
+    // Perf mode only times the Lua tests.
+    if (crawl_state.test_perf_runs <= 0)
+    {
+        _run_test("makeitem", makeitem_tests);
+        _run_test("mon-pick", debug_monpick);
+        _run_test("mon-data", debug_mondata);
+        _run_test("mon-spell", debug_monspells);
+        _run_test("coordit", coordit_tests);
+        _run_test("makename", make_name_tests);
+        _run_test("job-data", debug_jobdata);
+        _run_test("mon-bands", debug_bands);
+        _run_test("xom-data", validate_xom_events);
+    }
 
     // Get a list of Lua files in test.
     {
@@ -215,6 +389,9 @@ void run_tests()
         }
     }
 
+    if (crawl_state.test_perf_runs > 0 && !crawl_state.test_list)
+        _write_perf_report();
+
 #ifdef DEBUG_TAG_PROFILING
     tag_profile_out();
 #endif
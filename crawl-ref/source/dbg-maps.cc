@@ -7,6 +7,8 @@
 
 #include "dbg-maps.h"
 
+#include <chrono>
+
 #include "branch.h"
 #include "chardump.h"
 #include "crash.h"
@@ -46,10 +48,98 @@ static int build_attempts = 0, level_vetoes = 0;
 // Map from message to counts.
 static map<string, int> veto_messages;
 
+// Builder timing. Time spent on attempts that were thrown away is "wasted",
+// and is charged to the level and to every layout and vault the attempt
+// had placed.
+typedef chrono::steady_clock build_clock;
+static const char *levelgen_phase_names[] =
+{
+    "layout", "vaults", "features", "connectivity", "monsters", "items",
+    "finish",
+};
+COMPILE_CHECK(ARRAYSZ(levelgen_phase_names) == NUM_LEVELGEN_PHASES);
+
+static bool build_in_progress = false;
+static levelgen_phase build_phase = LGP_LAYOUT;
+static build_clock::time_point phase_start;
+static double attempt_ms[NUM_LEVELGEN_PHASES];
+static double built_phase_ms[NUM_LEVELGEN_PHASES];
+static double wasted_phase_ms[NUM_LEVELGEN_PHASES];
+static map<level_id, double> level_wasted_ms;
+// Map or layout name -> (wasted attempts, wasted ms).
+static map<string, pair<int, double> > map_wasted;
+// The layouts and vaults of the attempt in progress, noted before the
+// builder clears them.
+static set<string> attempt_maps;
+
+static void _end_phase()
+{
+    const chrono::duration<double, milli> elapsed =
+        build_clock::now() - phase_start;
+    attempt_ms[build_phase] += elapsed.count();
+}
+
+void mapstat_report_phase(levelgen_phase phase)
+{
+    if (!build_in_progress)
+        return;
+    _end_phase();
+    build_phase = phase;
+    phase_start = build_clock::now();
+}
+
+/// Note which layouts and vaults the current attempt used, so that time it
+/// wastes can be blamed on them even after the builder has cleared them.
+void mapstat_note_attempt_maps()
+{
+    for (const string &layout : env.level_layout_types)
+        attempt_maps.insert("layout_type " + layout);
+    for (const auto &vp : env.level_vaults)
+        attempt_maps.insert(vp->map.name);
+}
+
+void mapstat_report_map_build_end(bool success)
+{
+    if (!build_in_progress)
+        return;
+    _end_phase();
+    build_in_progress = false;
+
+    double total = 0;
+    for (int i = 0; i < NUM_LEVELGEN_PHASES; ++i)
+    {
+        (success ? built_phase_ms : wasted_phase_ms)[i] += attempt_ms[i];
+        total += attempt_ms[i];
+    }
+    if (success)
+        return;
+
+    level_wasted_ms[level_id::current()] += total;
+
+    mapstat_note_attempt_maps();
+    for (const string &name : attempt_maps)
+    {
+        pair<int, double> &waste = map_wasted[name];
+        waste.first++;
+        waste.second += total;
+    }
+}
+
 void mapstat_report_map_build_start()
 {
+    // builder() closes every attempt, including ones lost to a map load
+    // error.
+    ASSERT(!build_in_progress);
+
     build_attempts++;
     map_builds[level_id::current()].first++;
+
+    for (double &ms : attempt_ms)
+        ms = 0;
+    attempt_maps.clear();
+    build_in_progress = true;
+    build_phase = LGP_LAYOUT;
+    phase_start = build_clock::now();
 }
 
 void mapstat_report_map_veto(const string &message)
@@ -330,6 +420,51 @@ static void _check_mapless(const level_id &lid, vector<level_id> &mapless)
         mapless.push_back(lid);
 }
 
+static void _write_build_times(FILE *outf)
+{
+    fprintf(outf, "\n\nBuild time by phase (ms; built levels, vetoed "
+                  "attempts):\n");
+    double built_total = 0, wasted_total = 0;
+    for (int i = 0; i < NUM_LEVELGEN_PHASES; ++i)
+    {
+        fprintf(outf, "%-14s %12.1f %12.1f\n", levelgen_phase_names[i],
+                built_phase_ms[i], wasted_phase_ms[i]);
+        built_total += built_phase_ms[i];
+        wasted_total += wasted_phase_ms[i];
+    }
+    fprintf(outf, "%-14s %12.1f %12.1f\n", "total", built_total,
+            wasted_total);
+
+    if (level_wasted_ms.empty())
+        return;
+
+    fprintf(outf, "\n\nMost build time wasted on vetoes, by level:\n");
+    multimap<double, level_id> sortedlevels;
+    for (const auto &entry : level_wasted_ms)
+        sortedlevels.insert(make_pair(entry.second, entry.first));
+
+    int count = 0;
+    for (auto i = sortedlevels.rbegin(); i != sortedlevels.rend(); ++i)
+    {
+        fprintf(outf, "%3d) %s (%.1f ms)\n", ++count,
+                i->second.describe().c_str(), i->first);
+    }
+
+    fprintf(outf, "\n\nMost build time wasted on vetoes, by map and layout "
+                  "(top 50):\n");
+    multimap<double, string> sortedmaps;
+    for (const auto &entry : map_wasted)
+        sortedmaps.insert(make_pair(entry.second.second, entry.first));
+
+    count = 0;
+    for (auto i = sortedmaps.rbegin();
+         i != sortedmaps.rend() && count < 50; ++i)
+    {
+        fprintf(outf, "%3d) %s (%.1f ms in %d vetoed attempts)\n", ++count,
+                i->second.c_str(), i->first, map_wasted[i->second].first);
+    }
+}
+
 static void _write_map_stats()
 {
     const char *out_file = "mapstat.log";
@@ -416,6 +551,8 @@ static void _write_map_stats()
             fprintf(outf, "%3d) %s\n", i->first, i->second.c_str());
     }
 
+    _write_build_times(outf);
+
     if (!unused_maps.empty() && !SysEnv.map_gen_range)
     {
         fprintf(outf, "\n\nUnused maps:\n\n");
@@ -537,6 +674,8 @@ void mapstat_generate_stats()
 
     mapstat_build_levels();
 
+    // Don't leave the last attempt out of the timings if it never finished.
+    mapstat_report_map_build_end(false);
     _write_map_stats();
     printf("Map stats complete.\n");
 }
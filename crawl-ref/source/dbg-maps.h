@@ -5,6 +5,19 @@
 
 #pragma once
 
+// Stages of a level build, in order, for timing the builder.
+enum levelgen_phase
+{
+    LGP_LAYOUT,         // layout and primary vault
+    LGP_VAULTS,         // branch entrances, chance vaults, minivaults
+    LGP_FEATURES,       // ruination, uniques, mimics, traps
+    LGP_CONNECTIVITY,   // connectivity checks and interlevel fixups
+    LGP_MONSTERS,
+    LGP_ITEMS,
+    LGP_FINISH,         // stairs, transporters and postprocessing
+    NUM_LEVELGEN_PHASES
+};
+
 #ifdef DEBUG_STATISTICS
 
 class map_def;
@@ -14,7 +27,14 @@ void mapstat_report_map_success(const string &map_name);
 void mapstat_report_error(const map_def &map, const string &err);
 void mapstat_report_map_build_start();
 void mapstat_report_map_veto(const string &message);
+void mapstat_report_map_build_end(bool success);
+void mapstat_report_phase(levelgen_phase phase);
+void mapstat_note_attempt_maps();
 void mapstat_generate_stats();
 bool mapstat_build_levels();
 bool mapstat_find_forced_map();
+#else
+static inline void mapstat_report_map_build_end(bool) { }
+static inline void mapstat_report_phase(levelgen_phase) { }
+static inline void mapstat_note_attempt_maps() { }
 #endif
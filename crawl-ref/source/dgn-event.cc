@@ -8,36 +8,114 @@
 #include "dgn-event.h"
 
 #include <algorithm>
+#include <chrono>
 
 #include "coord.h"
 #include "libutil.h" // erase_val
 
 dgn_event_dispatcher dungeon_events;
 
+// Which counter slot an event type uses: the index of its lowest bit.
+static int _event_index(unsigned et)
+{
+    for (int i = 0; i < NUM_DGN_EVENT_TYPES; ++i)
+        if (et & (1 << i))
+            return i;
+    return -1;
+}
+
 void dgn_event_dispatcher::clear()
 {
     global_event_mask = 0;
+    position_event_mask = 0;
     listeners.clear();
+    for (auto &by_type : listeners_by_type)
+        by_type.clear();
     for (int y = 0; y < GYM; ++y)
         for (int x = 0; x < GXM; ++x)
             grid_triggers[x][y].reset(nullptr);
+    trigger_cells.reset();
+    listener_stats.clear();
 }
 
 void dgn_event_dispatcher::clear_listeners_at(const coord_def &pos)
 {
-    grid_triggers[pos.x][pos.y].reset(nullptr);
+    unique_ptr<dgn_square_alarm> alarm = move(grid_triggers[pos.x][pos.y]);
+    trigger_cells.set(pos, false);
+    if (alarm)
+        for (auto listener : alarm->listeners)
+            forget_listener(listener);
 }
 
 void dgn_event_dispatcher::move_listeners(
     const coord_def &from, const coord_def &to)
 {
     // Any existing listeners at to will be discarded. YHBW.
+    unique_ptr<dgn_square_alarm> discarded;
+    if (from != to)
+        discarded = move(grid_triggers[to.x][to.y]);
     grid_triggers[to.x][to.y] = move(grid_triggers[from.x][from.y]);
+    trigger_cells.set(to, trigger_cells(from));
+    trigger_cells.set(from, false);
+    if (discarded)
+        for (auto listener : discarded->listeners)
+            forget_listener(listener);
+}
+
+// Is the listener still registered, globally or on any square?
+bool dgn_event_dispatcher::is_registered(
+    const dgn_event_listener *listener) const
+{
+    for (const auto &ldef : listeners)
+        if (ldef.listener == listener)
+            return true;
+
+    for (int y = 0; y < GYM; ++y)
+        for (int x = 0; x < GXM; ++x)
+        {
+            if (!trigger_cells(x, y) || !grid_triggers[x][y])
+                continue;
+            const auto &alarm_listeners = grid_triggers[x][y]->listeners;
+            if (find(alarm_listeners.begin(), alarm_listeners.end(), listener)
+                != alarm_listeners.end())
+            {
+                return true;
+            }
+        }
+    return false;
+}
+
+// Drop the counts of a listener once its last registration is gone. The
+// map is keyed by address, so a stale entry could be picked up by whatever
+// gets allocated there next.
+void dgn_event_dispatcher::forget_listener(const dgn_event_listener *listener)
+{
+    if (listener_stats.count(listener) && !is_registered(listener))
+        listener_stats.erase(listener);
 }
 
 bool dgn_event_dispatcher::has_listeners_at(const coord_def &pos) const
 {
-    return grid_triggers[pos.x][pos.y].get();
+    return trigger_cells(pos);
+}
+
+bool dgn_event_dispatcher::notify(dgn_event_listener *listener,
+                                  const dgn_event &e)
+{
+    typedef chrono::steady_clock clock;
+
+    const int idx = _event_index(e.type);
+    if (idx >= 0)
+        counts[idx].notified++;
+
+    const auto start = clock::now();
+    const bool accepted = listener->notify_dgn_event(e);
+    const chrono::duration<double, milli> elapsed = clock::now() - start;
+
+    dgn_listener_counts &stats = listener_stats[listener];
+    stats.calls++;
+    stats.ms += elapsed.count();
+    return accepted;
 }
 
 bool dgn_event_dispatcher::fire_vetoable_position_event(
@@ -50,12 +128,19 @@ bool dgn_event_dispatcher::fire_vetoable_position_event(
 bool dgn_event_dispatcher::fire_vetoable_position_event(
     const dgn_event &et, const coord_def &pos)
 {
+    const int idx = _event_index(et.type);
+    if (idx >= 0)
+        counts[idx].fired++;
+
+    if (!(position_event_mask & et.type) || !trigger_cells(pos))
+        return true;
+
     dgn_square_alarm *alarm = grid_triggers[pos.x][pos.y].get();
     if (alarm && (alarm->eventmask & et.type))
     {
-        dgn_square_alarm alcopy(*alarm);
-        for (auto listener : alcopy.listeners)
-            if (!listener->notify_dgn_event(et))
+        const vector<dgn_event_listener*> targets = alarm->listeners;
+        for (auto listener : targets)
+            if (!notify(listener, et))
                 return false;
     }
     return true;
@@ -71,23 +156,35 @@ void dgn_event_dispatcher::fire_position_event(
 void dgn_event_dispatcher::fire_position_event(
     const dgn_event &et, const coord_def &pos)
 {
+    const int idx = _event_index(et.type);
+    if (idx >= 0)
+        counts[idx].fired++;
+
+    if (!(position_event_mask & et.type) || !trigger_cells(pos))
+        return;
+
     dgn_square_alarm *alarm = grid_triggers[pos.x][pos.y].get();
     if (alarm && (alarm->eventmask & et.type))
     {
-        dgn_square_alarm alcopy = *alarm;
-        for (auto listener : alcopy.listeners)
-            listener->notify_dgn_event(et);
+        const vector<dgn_event_listener*> targets = alarm->listeners;
+        for (auto listener : targets)
+            notify(listener, et);
     }
 }
 
 void dgn_event_dispatcher::fire_event(const dgn_event &e)
 {
+    const int idx = _event_index(e.type);
+    if (idx < 0)
+        return;
+    counts[idx].fired++;
+
     if (global_event_mask & e.type)
     {
-        auto copy = listeners;
-        for (const auto &ldef : copy)
-            if (ldef.eventmask & e.type)
-                ldef.listener->notify_dgn_event(e);
+        // Listeners may register or remove others as they go.
+        const vector<dgn_event_listener*> targets = listeners_by_type[idx];
+        for (auto listener : targets)
+            notify(listener, e);
     }
 }
 
@@ -96,6 +193,19 @@ void dgn_event_dispatcher::fire_event(dgn_event_type et)
     fire_event(dgn_event(et));
 }
 
+// Rebuild the per-type lists of global listeners, keeping each in the
+// order the listeners were first registered.
+void dgn_event_dispatcher::index_listeners()
+{
+    for (int i = 0; i < NUM_DGN_EVENT_TYPES; ++i)
+    {
+        listeners_by_type[i].clear();
+        for (const auto &ldef : listeners)
+            if (ldef.eventmask & (1 << i))
+                listeners_by_type[i].push_back(ldef.listener);
+    }
+}
+
 void dgn_event_dispatcher::register_listener(unsigned mask,
                                              dgn_event_listener *listener,
                                              const coord_def &pos)
@@ -105,15 +215,19 @@ void dgn_event_dispatcher::register_listener(unsigned mask,
     else
     {
         global_event_mask |= mask;
+        bool found = false;
         for (auto &ldef : listeners)
         {
             if (ldef.listener == listener)
             {
                 ldef.eventmask |= mask;
-                return;
+                found = true;
+                break;
             }
         }
-        listeners.emplace_back(mask, listener);
+        if (!found)
+            listeners.emplace_back(mask, listener);
+        index_listeners();
     }
 }
 
@@ -122,10 +236,14 @@ void dgn_event_dispatcher::register_listener_at(unsigned mask,
                                                 dgn_event_listener *listener)
 {
     if (!grid_triggers[c.x][c.y].get())
+    {
         grid_triggers[c.x][c.y].reset(new dgn_square_alarm);
+        trigger_cells.set(c);
+    }
 
     dgn_square_alarm *alarm = grid_triggers[c.x][c.y].get();
     alarm->eventmask |= mask;
+    position_event_mask |= mask;
     if (find(alarm->listeners.begin(), alarm->listeners.end(), listener)
         == alarm->listeners.end())
     {
@@ -145,6 +263,8 @@ void dgn_event_dispatcher::remove_listener(dgn_event_listener *listener,
             if (i->listener == listener)
             {
                 listeners.erase(i);
+                index_listeners();
+                forget_listener(listener);
                 return;
             }
         }
@@ -156,6 +276,51 @@ void dgn_event_dispatcher::remove_listener_at(const coord_def &pos,
 {
     if (dgn_square_alarm *alarm = grid_triggers[pos.x][pos.y].get())
         erase_val(alarm->listeners, listener);
+    forget_listener(listener);
+}
+
+vector<dgn_event_listener*> dgn_event_dispatcher::registered_listeners() const
+{
+    vector<dgn_event_listener*> result;
+    for (const auto &ldef : listeners)
+        result.push_back(ldef.listener);
+
+    for (int y = 0; y < GYM; ++y)
+        for (int x = 0; x < GXM; ++x)
+        {
+            if (!trigger_cells(x, y))
+                continue;
+            for (auto listener : grid_triggers[x][y]->listeners)
+                if (find(result.begin(), result.end(), listener)
+                    == result.end())
+                {
+                    result.push_back(listener);
+                }
+        }
+    return result;
+}
+
+const dgn_event_counts &
+dgn_event_dispatcher::event_counts(dgn_event_type et) const
+{
+    static const dgn_event_counts none;
+    const int idx = _event_index(et);
+    return idx < 0 ? none : counts[idx];
+}
+
+dgn_listener_counts
+dgn_event_dispatcher::listener_counts(const dgn_event_listener *l) const
+{
+    auto stats = listener_stats.find(l);
+    return stats == listener_stats.end() ? dgn_listener_counts()
+                                         : stats->second;
+}
+
+void dgn_event_dispatcher::reset_counts()
+{
+    for (auto &c : counts)
+        c = dgn_event_counts();
+    listener_stats.clear();
 }
 
 /////////////////////////////////////////////////////////////////////////////
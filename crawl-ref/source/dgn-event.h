@@ -5,8 +5,10 @@
 
 #pragma once
 
-#include <list>
+#include <map>
+#include <vector>
 
+#include "bitary.h"
 #include "player.h"
 
 // Keep event names in l-dgnevt.cc in sync.
@@ -43,6 +45,9 @@ enum dgn_event_type
                         | DET_PRESSURE_PLATE,
 };
 
+// One more than the highest bit used by dgn_event_type.
+#define NUM_DGN_EVENT_TYPES 17
+
 class dgn_event
 {
 public:
@@ -76,7 +81,7 @@ struct dgn_square_alarm
     dgn_square_alarm() : eventmask(0), listeners() { }
 
     unsigned eventmask;
-    list<dgn_event_listener*> listeners;
+    vector<dgn_event_listener*> listeners;
 };
 
 struct dgn_listener_def
@@ -90,13 +95,29 @@ struct dgn_listener_def
     dgn_event_listener *listener;
 };
 
+// How often an event type has been fired, and how many listener calls
+// that made.
+struct dgn_event_counts
+{
+    unsigned fired = 0;
+    unsigned notified = 0;
+};
+
+// Calls into one listener, and the time spent in them.
+struct dgn_listener_counts
+{
+    unsigned calls = 0;
+    double ms = 0;
+};
+
 // Listeners are not saved here. Map markers have their own
 // persistence and activation mechanisms. Other listeners must make
 // their own persistence arrangements.
 class dgn_event_dispatcher
 {
 public:
-    dgn_event_dispatcher() : global_event_mask(0), grid_triggers()
+    dgn_event_dispatcher() : global_event_mask(0), position_event_mask(0),
+                             grid_triggers()
     {
     }
 
@@ -121,15 +142,36 @@ public:
                            const coord_def &pos = coord_def());
     void remove_listener(dgn_event_listener *,
                          const coord_def &pos = coord_def());
+
+    // Every listener currently registered, global or positional.
+    vector<dgn_event_listener*> registered_listeners() const;
+
+    // Dispatch counters. Event counts survive level changes; listener
+    // counts are dropped once their listener's last registration is gone.
+    const dgn_event_counts &event_counts(dgn_event_type et) const;
+    dgn_listener_counts listener_counts(const dgn_event_listener *l) const;
+    void reset_counts();
+
 private:
     void register_listener_at(unsigned mask, const coord_def &pos,
                               dgn_event_listener *l);
     void remove_listener_at(const coord_def &pos, dgn_event_listener *l);
+    void index_listeners();
+    bool is_registered(const dgn_event_listener *l) const;
+    void forget_listener(const dgn_event_listener *l);
+    bool notify(dgn_event_listener *l, const dgn_event &e);
 
 private:
     unsigned global_event_mask;
+    unsigned position_event_mask;   // Union of all square alarm masks.
     unique_ptr<dgn_square_alarm> grid_triggers[GXM][GYM];
-    list<dgn_listener_def> listeners;
+    FixedBitArray<GXM, GYM> trigger_cells;
+    vector<dgn_listener_def> listeners;
+    // Global listeners for each event bit, in registration order.
+    vector<dgn_event_listener*> listeners_by_type[NUM_DGN_EVENT_TYPES];
+
+    dgn_event_counts counts[NUM_DGN_EVENT_TYPES];
+    map<const dgn_event_listener*, dgn_listener_counts> listener_stats;
 };
 
 extern dgn_event_dispatcher dungeon_events;
@@ -10,6 +10,7 @@
 #include <sstream>
 
 #include "l-libs.h"
+#include "libutil.h"
 #include "stringutil.h"
 
 static int dlua_compiled_chunk_writer(lua_State *ls, const void *p,
@@ -20,6 +21,21 @@ static int dlua_compiled_chunk_writer(lua_State *ls, const void *p,
     return 0;
 }
 
+// Bytecode for chunks compiled from source, keyed by chunk name and source
+// text. Every copy of a map_def (one per placement attempt) and every
+// subvault starts with only what the map cache gave it, so without this
+// a chunk stored as source would be recompiled each time it is tried.
+static map<string, string> _compiled_sources;
+static const size_t COMPILED_SOURCES_MAX = 4096;
+
+static string _compiled_source_key(const string &context, const string &chunk)
+{
+    string key = context;
+    key += '\0';
+    key += chunk;
+    return key;
+}
+
 ///////////////////////////////////////////////////////////////////////////
 // dlua_chunk
 
@@ -161,6 +177,13 @@ int dlua_chunk::load(CLua &interp)
         return E_CHUNK_LOAD_FAILURE;
     }
 
+    const string key = _compiled_source_key(context, chunk);
+    if (const string *bytecode = map_find(_compiled_sources, key))
+    {
+        compiled = *bytecode;
+        return load(interp);
+    }
+
     int err = check_op(interp,
                         interp.loadstring(chunk.c_str(), context.c_str()));
     if (err)
@@ -174,6 +197,12 @@ int dlua_chunk::load(CLua &interp)
         lua_pop(interp, 2);
     }
     compiled = out.str();
+    if (!err)
+    {
+        if (_compiled_sources.size() >= COMPILED_SOURCES_MAX)
+            _compiled_sources.clear();
+        _compiled_sources[key] = compiled;
+    }
     return err;
 }
 
@@ -252,6 +252,14 @@ set<string> &get_uniq_map_names()
 /**********************************************************************
  * builder() - kickoff for the dungeon generator.
  *********************************************************************/
+// Sweep up a build attempt's Lua garbage in one go, and give the blocks the
+// allocator was keeping for reuse back.
+static void _sweep_builder_lua()
+{
+    dlua.gc();
+    dlua.release_free_blocks();
+}
+
 bool builder(bool enable_random_maps)
 {
     // Re-check whether we're in a valid place, it leads to obscure errors
@@ -298,11 +306,17 @@ bool builder(bool enable_random_maps)
 
         try
         {
-            if (_build_level_vetoable(enable_random_maps))
+            const bool built = _build_level_vetoable(enable_random_maps);
+            mapstat_report_map_build_end(built);
+            if (built)
+            {
+                _sweep_builder_lua();
                 return true;
+            }
         }
         catch (map_load_exception &mload)
         {
+            mapstat_report_map_build_end(false);
             mprf(MSGCH_ERROR, "Failed to load map, reloading all maps (%s).",
                  mload.what());
             reread_maps();
@@ -310,6 +324,10 @@ bool builder(bool enable_random_maps)
 
         get_uniq_map_tags() = uniq_tags;
         get_uniq_map_names() = uniq_names;
+
+        // Don't let vetoed attempts pile up garbage for the next one, or
+        // leave it behind if this was the last.
+        _sweep_builder_lua();
     }
 
     if (!crawl_state.map_stat_gen && !crawl_state.obj_stat_gen)
@@ -391,6 +409,8 @@ static bool _build_level_vetoable(bool enable_random_maps)
 
     _dgn_postprocess_level();
 
+    // The epilogue below can still fail the attempt; remember what to blame.
+    mapstat_note_attempt_maps();
     env.level_layout_types.clear();
     env.level_uniq_maps.clear();
     env.level_uniq_map_tags.clear();
@@ -1294,9 +1314,11 @@ void dgn_reset_level(bool enable_random_maps)
     // Initialise all items.
     for (int i = 0; i < MAX_ITEMS; i++)
         init_item(i);
+    rebuild_free_item_slots();
 
     // Reset all monsters.
     reset_all_monsters();
+    rebuild_free_monster_slots();
     init_anon();
 
     // ... and Pan/regular spawn lists.
@@ -1478,6 +1500,7 @@ void fixup_misplaced_items()
         item.base_type = OBJ_UNASSIGNED;
         item.quantity = 0;
         item.pos.reset();
+        release_item_slot(item.index());
     }
 }
 
@@ -2418,6 +2441,8 @@ static void _build_dungeon_level()
 {
     bool place_vaults = _builder_by_type();
 
+    mapstat_report_phase(LGP_VAULTS);
+
     if (player_in_branch(BRANCH_SLIME))
         _slime_connectivity_fixup();
 
@@ -2460,6 +2485,8 @@ static void _build_dungeon_level()
             _place_chance_vaults();
         }
 
+        mapstat_report_phase(LGP_FEATURES);
+
         // Ruination and plant clumps.
         _post_vault_build();
 
@@ -2473,20 +2500,26 @@ static void _build_dungeon_level()
         _place_traps();
 
         // Any vault-placement activity must happen before this check.
+        mapstat_report_phase(LGP_CONNECTIVITY);
         _dgn_verify_connectivity(nvaults);
 
+        mapstat_report_phase(LGP_MONSTERS);
         _builder_monsters();
 
         // Place items.
+        mapstat_report_phase(LGP_ITEMS);
         _builder_items();
 
+        mapstat_report_phase(LGP_FINISH);
         _fixup_walls();
     }
     else
     {
         // Do ruination and plant clumps even in funny game modes, if
         // they happen to have the relevant branch.
+        mapstat_report_phase(LGP_FEATURES);
         _post_vault_build();
+        mapstat_report_phase(LGP_FINISH);
     }
 
     // Translate stairs for pandemonium levels.
@@ -630,10 +630,7 @@ public:
 
     bool launched_by(const item_def &launcher) const;
 
-    void clear()
-    {
-        *this = item_def();
-    }
+    void clear();
 
     /**
      * Sets this item as being held by a given monster.
@@ -846,11 +843,17 @@ private:
     typedef pair<coord_def, map_marker *> dgn_pos_marker;
 
     void init_from(const map_markers &);
+    void link_marker(map_marker *);
     void unlink_marker(const map_marker *);
+    bool has_markers_at(const coord_def &c) const;
     void check_empty();
 
 private:
     dgn_marker_map markers;
+    // The same markers again, split up by type.
+    dgn_marker_map markers_by_type[NUM_MAP_MARKER_TYPES];
+    // In-bounds cells that have at least one marker.
+    FixedBitArray<GXM, GYM> marker_cells;
     bool have_inactive_markers;
 };
 
@@ -19,6 +19,8 @@
 #include <cstdio>
 #include <cstdlib>
 #include <memory>
+#include <fcntl.h>
+#include <sys/stat.h>
 #ifndef TARGET_COMPILER_VC
 #include <unistd.h>
 #endif
@@ -49,6 +51,7 @@
 #include "state.h"
 #include "status.h"
 #include "stringutil.h"
+#include "syscalls.h"
 #ifdef USE_TILE
  #include "tilepick.h"
 #endif
@@ -63,15 +66,32 @@ using namespace ui;
 
 #define SCORE_VERSION "0.1"
 
-// enough memory allocated to snarf in the scorefile entries
-static unique_ptr<scorefile_entry> hs_list[SCORE_FILE_ENTRIES];
-static int hs_list_size = 0;
-static bool hs_list_initalized = false;
+// The scores file is append-only: new entries are written at the end, and
+// a binary sidecar index (the scores file name plus ".idx") records the
+// offset of each ranked entry, best first. The index is rebuilt from the
+// text whenever it is missing or does not describe the current file, so
+// old sorted scorefiles and hand-edited ones keep working.
+#define SCORE_INDEX_MAGIC   0x49534344 // "DCSI"
+#define SCORE_INDEX_VERSION 1
+
+struct hs_index_entry
+{
+    int32_t  points;
+    uint32_t offset;
+};
+
+// The ranked index of the current scores file, best entry first.
+static vector<hs_index_entry> hs_index;
+// Number of lines in the scores file, including ones that dropped off the
+// bottom of the table and are only kept until the next compaction.
+static uint32_t hs_index_lines = 0;
 
 static FILE *_hs_open(const char *mode, const string &filename);
 static void  _hs_close(FILE *handle, const string &filename);
 static bool  _hs_read(FILE *scores, scorefile_entry &dest);
 static void  _hs_write(FILE *scores, scorefile_entry &entry);
+static bool  _hs_load_index(FILE *scores, const string &filename);
+static bool  _hs_read_ranked(FILE *scores, int rank, scorefile_entry &dest);
 static time_t _parse_time(const string &st);
 static string _xlog_escape(const string &s);
 static string _xlog_unescape(const string &s);
@@ -92,97 +112,276 @@ static string _score_file_name()
     return ret;
 }
 
+static string _score_index_name(const string &scores)
+{
+    return scores + ".idx";
+}
+
 static string _log_file_name()
 {
     return Options.shared_dir + "logfile" + crawl_state.game_type_qualifier();
 }
 
-int hiscores_new_entry(const scorefile_entry &ne)
+static uint32_t _hs_file_size(FILE *scores)
 {
-    unwind_bool score_update(crawl_state.updating_scores, true);
+    fseek(scores, 0, SEEK_END);
+    const long size = ftell(scores);
+    return size < 0 ? 0 : size;
+}
 
-    FILE *scores;
-    int i;
-    bool inserted = false;
-    int newest_entry = -1;
+static void _hs_write_u32(FILE *f, uint32_t val)
+{
+    const uint8_t buf[4] = { (uint8_t) val, (uint8_t) (val >> 8),
+                             (uint8_t) (val >> 16), (uint8_t) (val >> 24) };
+    fwrite(buf, 1, sizeof buf, f);
+}
 
-    // open highscore file (reading) -- nullptr is fatal!
-    //
-    // Opening as a+ instead of r+ to force an exclusive lock (see
-    // hs_open) and to create the file if it's not there already.
-    scores = _hs_open("a+", _score_file_name());
-    if (scores == nullptr)
-        end(1, true, "failed to open score file for writing");
+static bool _hs_read_u32(FILE *f, uint32_t &val)
+{
+    uint8_t buf[4];
+    if (fread(buf, 1, sizeof buf, f) != sizeof buf)
+        return false;
+    val = buf[0] | buf[1] << 8 | buf[2] << 16 | (uint32_t) buf[3] << 24;
+    return true;
+}
 
-    // we're at the end of the file, seek back to beginning.
-    fseek(scores, 0, SEEK_SET);
+// Writes hs_index out to the sidecar file. The caller must hold the write
+// lock on the scores file; the index is locked as well, and gets the same
+// permissions as the scores file so that whoever can update one can update
+// the other.
+static void _hs_save_index(FILE *scores, const string &filename)
+{
+    const string idxname = _score_index_name(filename);
 
-    // read highscore file, inserting new entry at appropriate point,
-    for (i = 0; i < SCORE_FILE_ENTRIES; i++)
+    struct stat st;
+    const mode_t mode = fstat(fileno(scores), &st) ? 0666 : st.st_mode & 0777;
+    const int fd = open_u(idxname.c_str(), O_WRONLY|O_BINARY|O_CREAT, mode);
+    if (fd < 0 || !lock_file(fd, true) || ftruncate(fd, 0))
     {
-        hs_list[i].reset(new scorefile_entry);
-        if (_hs_read(scores, *hs_list[i]) == false)
-            break;
+        // Not fatal: the index will be rebuilt from the scores next time.
+        dprf("Unable to write score index %s", idxname.c_str());
+        if (fd >= 0)
+            close(fd);
+        return;
+    }
+    FILE *idx = fdopen(fd, "wb");
+    if (!idx)
+    {
+        close(fd);
+        return;
+    }
 
-        // compare points..
-        if (!inserted && ne.get_score() >= hs_list[i]->get_score())
-        {
-            newest_entry = i;           // for later printing
-            inserted = true;
-            // copy read entry to i+1th position
-            // Fixed a nasty overflow bug here -- Sharp
-            if (i+1 < SCORE_FILE_ENTRIES)
-            {
-                hs_list[i + 1] = move(hs_list[i]);
-                hs_list[i].reset(new scorefile_entry(ne));
-                i++;
-            }
-            else
-                *hs_list[i] = ne; // copy new entry to current position
-        }
+    _hs_write_u32(idx, SCORE_INDEX_MAGIC);
+    _hs_write_u32(idx, SCORE_INDEX_VERSION);
+    _hs_write_u32(idx, _hs_file_size(scores));
+    _hs_write_u32(idx, hs_index_lines);
+    _hs_write_u32(idx, hs_index.size());
+    for (const hs_index_entry &entry : hs_index)
+    {
+        _hs_write_u32(idx, (uint32_t) entry.points);
+        _hs_write_u32(idx, entry.offset);
+    }
+
+    const bool failed = fflush(idx) || ferror(idx);
+    lk_close(idx, idxname);
+    if (failed)
+        unlink_u(idxname.c_str());
+}
+
+// Tries to load the sidecar index; fails if it is missing, damaged, or was
+// written for a different version of the scores file.
+static bool _hs_read_index_file(FILE *scores, const string &filename)
+{
+    const string idxname = _score_index_name(filename);
+    FILE *idx = lk_open("rb", idxname);
+    if (!idx)
+        return false;
+
+    uint32_t magic, version, size, lines, count;
+    bool ok = _hs_read_u32(idx, magic) && magic == SCORE_INDEX_MAGIC
+              && _hs_read_u32(idx, version) && version == SCORE_INDEX_VERSION
+              && _hs_read_u32(idx, size) && size == _hs_file_size(scores)
+              && _hs_read_u32(idx, lines)
+              && _hs_read_u32(idx, count) && count <= SCORE_FILE_ENTRIES
+              && count <= lines;
+
+    hs_index.clear();
+    for (uint32_t i = 0; ok && i < count; ++i)
+    {
+        uint32_t points, offset;
+        ok = _hs_read_u32(idx, points) && _hs_read_u32(idx, offset)
+             && offset < size;
+        hs_index.push_back({ (int32_t) points, offset });
     }
+    lk_close(idx, idxname);
 
-    // special case: lowest score, with room
-    if (!inserted && i < SCORE_FILE_ENTRIES)
+    if (!ok)
     {
-        newest_entry = i;
-        inserted = true;
-        // copy new entry
-        hs_list[i].reset(new scorefile_entry(ne));
-        i++;
+        hs_index.clear();
+        return false;
     }
 
-    hs_list_size = i;
-    hs_list_initalized = true;
+    hs_index_lines = lines;
+    return true;
+}
+
+// Rebuilds hs_index by scanning the whole scores file.
+static void _hs_rebuild_index(FILE *scores)
+{
+    hs_index.clear();
+    hs_index_lines = 0;
 
-    // If we've still not inserted it, it's not a highscore.
-    if (!inserted)
+    // Death times, to order tied scores.
+    vector<time_t> died;
+    fseek(scores, 0, SEEK_SET);
+    while (true)
     {
-        _hs_close(scores, _score_file_name());
-        return -1;
+        const long offset = ftell(scores);
+        scorefile_entry se;
+        if (offset < 0 || !_hs_read(scores, se))
+            break;
+        hs_index.push_back({ se.get_score(), (uint32_t) offset });
+        died.push_back(se.get_death_time());
+        ++hs_index_lines;
+    }
+
+    // Like hiscores_new_entry(), put newer entries above older ones with
+    // the same score. The file mixes rank-ordered and appended lines, so
+    // its order can't be relied on for that.
+    vector<int> order(hs_index.size());
+    for (int i = 0; i < (int) order.size(); ++i)
+        order[i] = i;
+    stable_sort(order.begin(), order.end(),
+                [&](int a, int b)
+                {
+                    if (hs_index[a].points != hs_index[b].points)
+                        return hs_index[a].points > hs_index[b].points;
+                    return died[a] > died[b];
+                });
+    vector<hs_index_entry> ranked;
+    for (int i : order)
+        ranked.push_back(hs_index[i]);
+    hs_index.swap(ranked);
+    if (hs_index.size() > SCORE_FILE_ENTRIES)
+        hs_index.resize(SCORE_FILE_ENTRIES);
+}
+
+// Loads the index for an open scores file into hs_index, rebuilding it from
+// the text if necessary. Returns true if the sidecar needs to be rewritten.
+static bool _hs_load_index(FILE *scores, const string &filename)
+{
+    // Standard input can't be seeked, so it never has an index.
+    if (scores == stdin || _hs_read_index_file(scores, filename))
+        return false;
+
+    _hs_rebuild_index(scores);
+    return true;
+}
+
+// Opens the scores file for reading, with hs_index loaded. If the sidecar
+// index was missing, damaged or out of date it is rewritten first, which
+// needs the write lock, so the read lock is given up while that happens.
+static FILE *_hs_open_ranked(const string &filename)
+{
+    FILE *scores = _hs_open("r", filename);
+    if (!scores || !_hs_load_index(scores, filename))
+        return scores;
+
+    dprf("Score index for %s rebuilt from the scores file.",
+         filename.c_str());
+    _hs_close(scores, filename);
+
+    // Someone else may have fixed it in the meantime.
+    if (FILE *rw = _hs_open("r+", filename))
+    {
+        if (_hs_load_index(rw, filename))
+            _hs_save_index(rw, filename);
+        _hs_close(rw, filename);
+    }
+
+    scores = _hs_open("r", filename);
+    if (scores)
+        _hs_load_index(scores, filename);
+    return scores;
+}
+
+// Rewrites the scores file with only the ranked entries, in rank order, once
+// enough entries have fallen off the bottom of the table.
+static void _hs_compact(FILE *scores)
+{
+    vector<string> lines;
+    for (int i = 0; i < (int) hs_index.size(); ++i)
+    {
+        scorefile_entry se;
+        if (!_hs_read_ranked(scores, i, se))
+            return;
+        lines.push_back(se.raw_string());
     }
 
-    // The old code closed and reopened the score file, leading to a
-    // race condition where one Crawl process could overwrite the
-    // other's highscore. Now we truncate and rewrite the file without
-    // closing it.
     if (ftruncate(fileno(scores), 0))
         end(1, true, "unable to truncate scorefile");
-
     rewind(scores);
 
-    // write scorefile entries.
-    for (i = 0; i < hs_list_size; i++)
+    uint32_t offset = 0;
+    for (int i = 0; i < (int) lines.size(); ++i)
     {
-        _hs_write(scores, *hs_list[i]);
+        fputs(lines[i].c_str(), scores);
+        hs_index[i].offset = offset;
+        offset += lines[i].length();
+    }
+    hs_index_lines = lines.size();
+}
+
+int hiscores_new_entry(const scorefile_entry &ne)
+{
+    unwind_bool score_update(crawl_state.updating_scores, true);
 
-        // Leave in memory. Does this anyway if !inserted.
-        // Can write cleanup function if nessicary??
-        // hs_list[i].reset(nullptr);
+    // open highscore file (reading) -- nullptr is fatal!
+    //
+    // Opening as a+ instead of r+ to force an exclusive lock (see
+    // hs_open) and to create the file if it's not there already.
+    const string filename = _score_file_name();
+    FILE *scores = _hs_open("a+", filename);
+    if (scores == nullptr)
+        end(1, true, "failed to open score file for writing");
+
+    const bool stale_index = _hs_load_index(scores, filename);
+
+    // New entries go above existing entries with the same score.
+    const auto pos = lower_bound(hs_index.begin(), hs_index.end(),
+                                 ne.get_score(),
+                                 [](const hs_index_entry &entry, int points)
+                                 { return entry.points > points; });
+    const int newest_entry = pos - hs_index.begin();
+
+    // If it doesn't make the table, it's not a highscore.
+    if (newest_entry >= SCORE_FILE_ENTRIES)
+    {
+        if (stale_index)
+            _hs_save_index(scores, filename);
+        _hs_close(scores, filename);
+        return -1;
     }
 
+    // The old code read and rewrote the whole scorefile for every new
+    // entry; now we only append, under the same lock, and update the index.
+    const uint32_t offset = _hs_file_size(scores);
+    scorefile_entry se = ne;
+    _hs_write(scores, se);
+    fflush(scores);
+
+    hs_index.insert(pos, { ne.get_score(), offset });
+    if (hs_index.size() > SCORE_FILE_ENTRIES)
+        hs_index.pop_back();
+    ++hs_index_lines;
+
+    if (hs_index_lines > 2 * SCORE_FILE_ENTRIES)
+        _hs_compact(scores);
+
+    _hs_save_index(scores, filename);
+
     // close scorefile.
-    _hs_close(scores, _score_file_name());
+    _hs_close(scores, filename);
     return newest_entry;
 }
 
@@ -228,30 +427,19 @@ static void _hiscores_print_entry(const scorefile_entry &se,
     pf("%s", entry.c_str());
 }
 
-// Reads hiscores file to memory
+// Reads the hiscores index to memory; entries themselves are only read when
+// they are displayed.
 void hiscores_read_to_memory()
 {
-    FILE *scores;
-    int i;
+    const string filename = _score_file_name();
 
     // open highscore file (reading)
-    scores = _hs_open("r", _score_file_name());
+    FILE *scores = _hs_open_ranked(filename);
     if (scores == nullptr)
         return;
 
-    // read highscore file
-    for (i = 0; i < SCORE_FILE_ENTRIES; i++)
-    {
-        hs_list[i].reset(new scorefile_entry);
-        if (_hs_read(scores, *hs_list[i]) == false)
-            break;
-    }
-
-    hs_list_size = i;
-    hs_list_initalized = true;
-
     //close off
-    _hs_close(scores, _score_file_name());
+    _hs_close(scores, filename);
 }
 
 // Writes all entries in the scorefile to stdout in human-readable form.
@@ -259,7 +447,8 @@ void hiscores_print_all(int display_count, int format)
 {
     unwind_bool scorefile_display(crawl_state.updating_scores, true);
 
-    FILE *scores = _hs_open("r", _score_file_name());
+    const string filename = _score_file_name();
+    FILE *scores = _hs_open_ranked(filename);
     if (scores == nullptr)
     {
         // will only happen from command line
@@ -270,7 +459,7 @@ void hiscores_print_all(int display_count, int format)
     for (int entry = 0; display_count <= 0 || entry < display_count; ++entry)
     {
         scorefile_entry se;
-        if (!_hs_read(scores, se))
+        if (!_hs_read_ranked(scores, entry, se))
             break;
 
         if (format == -1)
@@ -279,7 +468,7 @@ void hiscores_print_all(int display_count, int format)
             _hiscores_print_entry(se, entry, format, printf);
     }
 
-    _hs_close(scores, _score_file_name());
+    _hs_close(scores, filename);
 }
 
 // Displays high scores using curses. For output to the console, use
@@ -289,17 +478,19 @@ string hiscores_print_list(int display_count, int format, int newest_entry, int&
     unwind_bool scorefile_display(crawl_state.updating_scores, true);
     string ret;
 
-    // Additional check to preserve previous functionality
-    if (!hs_list_initalized) {
-        hiscores_read_to_memory();
-    }
-
     int i, total_entries;
 
     if (display_count <= 0)
         return "";
 
-    total_entries = hs_list_size;
+    const string filename = _score_file_name();
+    // Another game may have added to or compacted the file since the index
+    // was last read, so the offsets must be reloaded under this lock.
+    FILE *scores = _hs_open_ranked(filename);
+    if (scores == nullptr)
+        return "";
+
+    total_entries = hs_index.size();
 
     int start = newest_entry - display_count / 2;
 
@@ -313,11 +504,15 @@ string hiscores_print_list(int display_count, int format, int newest_entry, int&
 
     for (i = start; i < finish && i < total_entries; i++)
     {
+        scorefile_entry se;
+        if (!_hs_read_ranked(scores, i, se))
+            break;
+
         // check for recently added entry
         if (i == newest_entry)
             ret += "<yellow>";
 
-        _hiscores_print_entry(*hs_list[i], i, format, [&ret](const char *fmt, const char *s){
+        _hiscores_print_entry(se, i, format, [&ret](const char *fmt, const char *s){
             ret += string(s);
         });
 
@@ -326,6 +521,8 @@ string hiscores_print_list(int display_count, int format, int newest_entry, int&
             ret += "<lightgrey>";
     }
 
+    _hs_close(scores, filename);
+
     start_out = start;
     return ret;
 }
@@ -438,24 +635,22 @@ UIHiscoresMenu::UIHiscoresMenu()
 
 void UIHiscoresMenu::_construct_hiscore_table()
 {
-    FILE *scores = _hs_open("r", _score_file_name());
+    const string filename = _score_file_name();
+    FILE *scores = _hs_open_ranked(filename);
 
     if (scores == nullptr)
         return;
 
-    int i;
     // read highscore file
-    for (i = 0; i < SCORE_FILE_ENTRIES; i++)
+    for (int i = 0; i < SCORE_FILE_ENTRIES; i++)
     {
-        hs_list[i].reset(new scorefile_entry);
-        if (_hs_read(scores, *hs_list[i]) == false)
+        scorefile_entry se;
+        if (!_hs_read_ranked(scores, i, se))
             break;
+        _add_hiscore_row(se, i);
     }
 
-    _hs_close(scores, _score_file_name());
-
-    for (int j=0; j<i; j++)
-        _add_hiscore_row(*hs_list[j], j);
+    _hs_close(scores, filename);
 }
 
 void UIHiscoresMenu::_add_hiscore_row(scorefile_entry& se, int id)
@@ -470,7 +665,8 @@ void UIHiscoresMenu::_add_hiscore_row(scorefile_entry& se, int id)
         if (ev.type == WME_MOUSEBUTTONUP && ev.mouse_event.button == MouseEvent::LEFT
                 || ev.type == WME_KEYDOWN && ev.key.keysym.sym == CK_ENTER)
         {
-            _show_morgue(*hs_list[id]);
+            scorefile_entry entry = se;
+            _show_morgue(entry);
             return true;
         }
         if (ev.type == WME_FOCUSIN)
@@ -617,6 +813,23 @@ static bool _hs_read(FILE *scores, scorefile_entry &dest)
     return dest.parse(inbuf);
 }
 
+// Reads the entry at the given rank, using the index loaded by
+// _hs_load_index(). Without an index (reading from stdin) entries can only
+// be read in file order.
+static bool _hs_read_ranked(FILE *scores, int rank, scorefile_entry &dest)
+{
+    if (scores == stdin)
+        return _hs_read(scores, dest);
+
+    if (rank < 0 || rank >= (int) hs_index.size()
+        || fseek(scores, hs_index[rank].offset, SEEK_SET))
+    {
+        return false;
+    }
+
+    return _hs_read(scores, dest);
+}
+
 static int _val_char(char digit)
 {
     return digit - '0';
@@ -1195,6 +1195,7 @@ void game_options::reset_options()
     sound_mappings.clear();
     menu_colour_mappings.clear();
     message_colour_mappings.clear();
+    invalidate_message_filters();
     named_options.clear();
 
     clear_cset_overrides();
@@ -1822,6 +1823,9 @@ void game_options::read_options(LineInput &il, bool runscript,
     if (clear_aliases)
         aliases.clear();
 
+    // Options and Lua hooks can change how stash items are annotated.
+    StashTrack.invalidate_search_text();
+
     dlua_chunk luacond(filename);
     dlua_chunk luacode(filename);
 
@@ -2488,6 +2492,9 @@ void game_options::read_option_line(const string &str, bool runscript)
         else                                                                   \
             _opt.push_back(_conv(part));                                       \
     }
+    StashTrack.invalidate_search_text();
+    invalidate_message_filters();
+
     string key    = "";
     string subkey = "";
     string field  = "";
@@ -3890,6 +3897,7 @@ enum commandline_option_type
     CLO_ARENA,
     CLO_DUMP_MAPS,
     CLO_TEST,
+    CLO_PERF,
     CLO_SCRIPT,
     CLO_BUILDDB,
     CLO_HELP,
@@ -3926,8 +3934,9 @@ static const char *cmd_ops[] =
 {
     "scores", "name", "species", "background", "dir", "rc", "rcdir", "tscores",
     "vscores", "scorefile", "morgue", "macro", "mapstat", "dump-disconnect",
-    "objstat", "iters", "force-map", "arena", "dump-maps", "test", "script",
-    "builddb", "help", "version", "seed", "pregen", "save-version", "sprint",
+    "objstat", "iters", "force-map", "arena", "dump-maps", "test", "perf",
+    "script", "builddb", "help", "version", "seed", "pregen", "save-version",
+    "sprint",
     "extra-opt-first", "extra-opt-last", "sprint-map", "edit-save",
     "print-charset", "tutorial", "wizard", "explore", "no-save", "gdb",
     "no-gdb", "nogdb", "throttle", "no-throttle", "playable-json",
@@ -4855,6 +4864,22 @@ bool parse_args(int argc, char **argv, bool rc_only)
             }
             break;
 
+        case CLO_PERF:
+            crawl_state.test = true;
+            crawl_state.test_perf_runs = 5;
+            if (next_is_param)
+            {
+                if (!parse_int(next_arg, crawl_state.test_perf_runs)
+                    || crawl_state.test_perf_runs < 1)
+                {
+                    fprintf(stderr, "-perf takes a positive number of runs, "
+                                    "not '%s'.\n", next_arg);
+                    return false;
+                }
+                nextUsed = true;
+            }
+            break;
+
         case CLO_SCRIPT:
             crawl_state.test   = true;
             crawl_state.script = true;
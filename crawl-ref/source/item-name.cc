@@ -38,6 +38,7 @@
 #include "level-state-type.h"
 #include "libutil.h"
 #include "makeitem.h"
+#include "mon-info.h"
 #include "notes.h"
 #include "options.h"
 #include "orb-type.h"
@@ -2370,6 +2371,8 @@ bool set_ident_type(object_class_type basetype, int subtype, bool identify)
 
     you.type_ids[basetype][subtype] = identify;
     request_autoinscribe();
+    // Monsters' items may now show up as identified.
+    invalidate_monster_info_cache();
 
     // Our item knowledge changed in a way that could possibly affect shop
     // prices.
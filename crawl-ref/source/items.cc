@@ -14,6 +14,7 @@
 #include <cstring>
 #include <functional> // mem_fn
 #include <limits>
+#include <queue>
 
 #include "adjust.h"
 #include "areas.h"
@@ -504,6 +505,52 @@ void init_item(int item)
     mitm[item].clear();
 }
 
+// Candidate free mitm slots, lowest first. item_def::clear() (and so
+// destroy_item()) pushes every mitm slot it empties, as do the few places
+// that free a slot by hand, so get_mitm_slot() still hands out the lowest
+// free slot. A slot freed any other way is only found again by the rescan
+// that follows an empty heap. Slots also get filled behind our back (level
+// loading), so entries are checked when they come off the heap.
+static priority_queue<int, vector<int>, greater<int>> _free_item_slots;
+
+void release_item_slot(int item)
+{
+    ASSERT_RANGE(item, 0, MAX_ITEMS);
+    // Slots are pushed again each time they are cleared; don't let the
+    // duplicates pile up.
+    if (_free_item_slots.size() > 2 * MAX_ITEMS)
+        rebuild_free_item_slots();
+    else
+        _free_item_slots.push(item);
+}
+
+void rebuild_free_item_slots()
+{
+    vector<int> slots;
+    for (int i = 0; i < MAX_ITEMS; ++i)
+        if (!mitm[i].defined())
+            slots.push_back(i);
+
+    _free_item_slots = priority_queue<int, vector<int>, greater<int>>(
+                           greater<int>(), move(slots));
+}
+
+// Returns the lowest known free slot below limit, or NON_ITEM.
+static int _pop_free_item_slot(int limit)
+{
+    while (!_free_item_slots.empty())
+    {
+        const int item = _free_item_slots.top();
+        if (item >= limit && !mitm[item].defined())
+            return NON_ITEM;
+
+        _free_item_slots.pop();
+        if (!mitm[item].defined())
+            return item;
+    }
+    return NON_ITEM;
+}
+
 // Returns an unused mitm slot, or NON_ITEM if none available.
 // The reserve is the number of item slots to not check.
 // Items may be culled if a reserve <= 10 is specified.
@@ -514,13 +561,14 @@ int get_mitm_slot(int reserve)
     if (crawl_state.game_is_arena())
         reserve = 0;
 
-    int item = NON_ITEM;
-
-    for (item = 0; item < (MAX_ITEMS - reserve); item++)
-        if (!mitm[item].defined())
-            break;
+    int item = _pop_free_item_slot(MAX_ITEMS - reserve);
+    if (item == NON_ITEM)
+    {
+        rebuild_free_item_slots();
+        item = _pop_free_item_slot(MAX_ITEMS - reserve);
+    }
 
-    if (item >= MAX_ITEMS - reserve)
+    if (item == NON_ITEM)
     {
         if (crawl_state.game_is_arena())
         {
@@ -539,7 +587,9 @@ int get_mitm_slot(int reserve)
 
     ASSERT(item != NON_ITEM);
 
-    init_item(item);
+    // Not clear(): that would put the slot we're handing out back on the
+    // heap.
+    mitm[item] = item_def();
 
     return item;
 }
@@ -3458,6 +3508,13 @@ int item_def::index() const
     return this - mitm.buffer();
 }
 
+void item_def::clear()
+{
+    *this = item_def();
+    if (this >= &mitm[0] && this < &mitm[0] + MAX_ITEMS)
+        release_item_slot(index());
+}
+
 int item_def::armour_rating() const
 {
     if (!defined() || base_type != OBJ_ARMOURS)
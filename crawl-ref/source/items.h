@@ -78,6 +78,8 @@ void link_items();
 void fix_item_coordinates();
 
 int get_mitm_slot(int reserve = 50);
+void rebuild_free_item_slots();
+void release_item_slot(int item);
 
 void unlink_item(int dest);
 void destroy_item(item_def &item, bool never_created = false);
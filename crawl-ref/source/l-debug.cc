@@ -431,6 +431,34 @@ LUAFN(debug_get_rng_state)
     return 1;
 }
 
+// Allocation counters for this Lua VM: a table of allocs, frees, bytes,
+// pooled (allocs that reused a freed block), peak and in_use (bytes).
+LUAFN(debug_lua_alloc_stats)
+{
+    const CLua &vm = CLua::get_vm(ls);
+    lua_newtable(ls);
+    lua_pushnumber(ls, vm.alloc_stats.allocs);
+    lua_setfield(ls, -2, "allocs");
+    lua_pushnumber(ls, vm.alloc_stats.frees);
+    lua_setfield(ls, -2, "frees");
+    lua_pushnumber(ls, vm.alloc_stats.bytes);
+    lua_setfield(ls, -2, "bytes");
+    lua_pushnumber(ls, vm.alloc_stats.pooled);
+    lua_setfield(ls, -2, "pooled");
+    lua_pushnumber(ls, vm.alloc_stats.peak);
+    lua_setfield(ls, -2, "peak");
+    lua_pushnumber(ls, vm.memory_used);
+    lua_setfield(ls, -2, "in_use");
+    return 1;
+}
+
+// Zero the allocation counters; peak restarts from the current use.
+LUAFN(debug_reset_lua_alloc_stats)
+{
+    CLua::get_vm(ls).reset_alloc_stats();
+    return 0;
+}
+
 const struct luaL_reg debug_dlib[] =
 {
 { "goto_place", debug_goto_place },
@@ -461,5 +489,7 @@ const struct luaL_reg debug_dlib[] =
 { "cpp_assert", debug_cpp_assert },
 { "reset_rng", debug_reset_rng },
 { "get_rng_state", debug_get_rng_state },
+{ "lua_alloc_stats", debug_lua_alloc_stats },
+{ "reset_lua_alloc_stats", debug_reset_lua_alloc_stats },
 { nullptr, nullptr }
 };
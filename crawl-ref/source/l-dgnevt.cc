@@ -7,6 +7,8 @@
 
 #include "cluautil.h"
 #include "dgn-event.h"
+#include "mapmark.h"
+#include "stringutil.h"
 
 /*
  * Methods for DEVENT_METATABLE.
@@ -145,11 +147,68 @@ static int dgn_dgn_event_is_position(lua_State *ls)
     return 1;
 }
 
+// Dispatch counters: a table with "events", mapping each event name to
+// { fired, notified }, and "listeners", a list of { desc, calls, ms } for
+// the listeners registered on this level.
+static int dgn_dgn_event_stats(lua_State *ls)
+{
+    lua_newtable(ls);
+
+    lua_newtable(ls);
+    for (unsigned i = 1; i < ARRAYSZ(dgn_event_type_names); ++i)
+    {
+        const dgn_event_type et = static_cast<dgn_event_type>(1 << (i - 1));
+        const dgn_event_counts &counts = dungeon_events.event_counts(et);
+        lua_newtable(ls);
+        lua_pushnumber(ls, counts.fired);
+        lua_setfield(ls, -2, "fired");
+        lua_pushnumber(ls, counts.notified);
+        lua_setfield(ls, -2, "notified");
+        lua_setfield(ls, -2, dgn_event_type_names[i]);
+    }
+    lua_setfield(ls, -2, "events");
+
+    lua_newtable(ls);
+    int n = 0;
+    for (const dgn_event_listener *listener
+         : dungeon_events.registered_listeners())
+    {
+        const dgn_listener_counts counts =
+            dungeon_events.listener_counts(listener);
+        string desc = "unknown";
+        if (const map_marker *mark = dynamic_cast<const map_marker*>(listener))
+        {
+            desc = make_stringf("%s at (%d,%d)",
+                                mark->debug_describe().c_str(),
+                                mark->pos.x, mark->pos.y);
+        }
+
+        lua_newtable(ls);
+        lua_pushstring(ls, desc.c_str());
+        lua_setfield(ls, -2, "desc");
+        lua_pushnumber(ls, counts.calls);
+        lua_setfield(ls, -2, "calls");
+        lua_pushnumber(ls, counts.ms);
+        lua_setfield(ls, -2, "ms");
+        lua_rawseti(ls, -2, ++n);
+    }
+    lua_setfield(ls, -2, "listeners");
+    return 1;
+}
+
+static int dgn_dgn_reset_event_stats(lua_State * /*ls*/)
+{
+    dungeon_events.reset_counts();
+    return 0;
+}
+
 const struct luaL_reg dgn_event_dlib[] =
 {
 { "dgn_event_type",        dgn_dgn_event },
 { "dgn_event_is_global",   dgn_dgn_event_is_global },
 { "dgn_event_is_position", dgn_dgn_event_is_position},
+{ "dgn_event_stats",       dgn_dgn_event_stats },
+{ "reset_dgn_event_stats", dgn_dgn_reset_event_stats },
 
 { nullptr, nullptr }
 };
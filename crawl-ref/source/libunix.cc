@@ -73,6 +73,50 @@ static COLOURS BG_COL = BLACK;
 /** @brief The default background @em colour. */
 static COLOURS BG_COL_DEFAULT = BLACK;
 
+/**
+ * @brief What puttext() last put on each cell of the rectangle it drew.
+ *
+ * puttext() redraws the whole view every turn, even though usually only a
+ * handful of cells have changed. Remembering the previous frame lets it skip
+ * the unchanged cells, and with them most of the cursor moves and colour
+ * changes. Anything else that writes inside the rectangle forgets the cells
+ * it touched, so they are drawn again next time.
+ */
+struct puttext_frame
+{
+    coord_def origin;                 // curses (0-based) top-left.
+    coord_def size;
+    COLOURS background = BLACK;
+    vector<screen_cell_t> cells;
+};
+static puttext_frame last_frame;
+
+/** @brief Marks a remembered cell as needing to be redrawn. */
+static const unsigned short STALE_CELL_COLOUR = 0xFFFF;
+
+static void _forget_frame()
+{
+    last_frame.cells.clear();
+}
+
+/**
+ * @brief Forget remembered cells on curses row y, columns [x1, x2).
+ */
+static void _forget_frame_cells(int y, int x1, int x2)
+{
+    if (last_frame.cells.empty())
+        return;
+
+    y -= last_frame.origin.y;
+    if (y < 0 || y >= last_frame.size.y)
+        return;
+
+    x1 = max(x1 - last_frame.origin.x, 0);
+    x2 = min(x2 - last_frame.origin.x, last_frame.size.x);
+    for (int x = x1; x < x2; ++x)
+        last_frame.cells[y * last_frame.size.x + x].colour = STALE_CELL_COLOUR;
+}
+
 struct curses_style
 {
     attr_t attr;
@@ -730,6 +774,7 @@ void console_startup()
 
     // Must call refresh() for ncurses to update COLS and LINES.
     refresh();
+    _forget_frame();
     crawl_view.init_geometry();
 
     set_mouse_enabled(false);
@@ -776,7 +821,7 @@ void cprintf(const char *format, ...)
     }
 }
 
-void putwch(char32_t chr)
+static void _putwch(char32_t chr)
 {
     wchar_t c = chr;
     if (!c)
@@ -792,17 +837,63 @@ void putwch(char32_t chr)
 #endif
 }
 
+void putwch(char32_t chr)
+{
+    int y, x;
+    getyx(stdscr, y, x);
+    _putwch(chr);
+
+    // Wide characters may cover more than one cell.
+    int ny, nx;
+    getyx(stdscr, ny, nx);
+    _forget_frame_cells(y, x, ny == y ? max(nx, x + 1) : COLS);
+}
+
 void puttext(int x1, int y1, const crawl_view_buffer &vbuf)
 {
     const screen_cell_t *cell = vbuf;
     const coord_def size = vbuf.size();
+
+    cgotoxy(x1, y1);
+    coord_def origin;
+    getyx(stdscr, origin.y, origin.x);
+
+    // Only diff against the previous frame if it covered the same rectangle
+    // with the same background; otherwise redraw (and remember) everything.
+    const bool diff = origin == last_frame.origin && size == last_frame.size
+                      && BG_COL == last_frame.background
+                      && !last_frame.cells.empty();
+    if (!diff)
+    {
+        last_frame.origin = origin;
+        last_frame.size = size;
+        last_frame.background = BG_COL;
+        last_frame.cells.assign(size.x * size.y,
+                                { 0, STALE_CELL_COLOUR, 0 });
+    }
+
+    screen_cell_t *old = last_frame.cells.data();
     for (int y = 0; y < size.y; ++y)
     {
-        cgotoxy(x1, y1 + y);
-        for (int x = 0; x < size.x; ++x)
+        // Move the cursor only at the start of each run of changed cells.
+        bool placed = false;
+        for (int x = 0; x < size.x; ++x, ++cell, ++old)
         {
-            put_colour_ch(cell->colour, cell->glyph);
-            cell++;
+            if (cell->colour == old->colour && cell->glyph == old->glyph)
+            {
+                placed = false;
+                continue;
+            }
+
+            if (!placed)
+            {
+                cgotoxy(x1 + x, y1 + y);
+                placed = true;
+            }
+            textcolour(cell->colour);
+            _putwch(cell->glyph);
+            old->glyph = cell->glyph;
+            old->colour = cell->colour;
         }
     }
     update_screen();
@@ -832,7 +923,10 @@ void clear_to_end_of_line()
 {
     textcolour(LIGHTGREY);
     textbackground(BLACK);
+    int y, x;
+    getyx(stdscr, y, x);
     clrtoeol();
+    _forget_frame_cells(y, x, COLS);
 
 #ifdef USE_TILE_WEB
     tiles.clear_to_end_of_line();
@@ -859,6 +953,7 @@ void clrscr()
     textcolour(LIGHTGREY);
     textbackground(BLACK);
     clear();
+    _forget_frame();
 #ifdef DGAMELAUNCH
     printf("%s", DGL_CLEAR_SCREEN);
     fflush(stdout);
@@ -1416,6 +1511,7 @@ static void write_char_at(int y, int x, const cchar_t &ch)
 
     attr_set(attr, color_pair, nullptr);
     mvadd_wchnstr(y, x, &ch, 1);
+    _forget_frame_cells(y, x, x + 1);
 }
 
 // see declaration
@@ -84,6 +84,17 @@ static blockrays_t blockrays;
 struct cellray;
 static FixedArray<vector<cellray>, LOS_MAX_RANGE+1, LOS_MAX_RANGE+1> min_cellrays;
 
+// The inner cells of each minimal cellray, as a range of ray_coords, in the
+// same order as min_cellrays. find_ray only needs these to test a cellray,
+// and they are much smaller than a full cellray.
+struct cellray_span
+{
+    unsigned int start; // First inner cell, as an index into ray_coords.
+    unsigned int end;   // One past the last inner cell.
+};
+static FixedArray<vector<cellray_span>, LOS_MAX_RANGE+1, LOS_MAX_RANGE+1>
+    min_cellray_spans;
+
 // Temporary arrays used in losight() to track which rays
 // are blocked or have seen a smoke cloud.
 // Allocated when doing the precomputations.
@@ -362,6 +373,8 @@ static vector<int> _find_minimal_cellrays()
         }
         min.sort(_is_better);
         min_cellrays(*qi) = vector<cellray>(min.begin(), min.end());
+        for (const cellray &c : min)
+            min_cellray_spans(*qi).push_back({c.ray.start, c.ray.start + c.end});
     }
     return result;
 }
@@ -542,10 +555,12 @@ void cellray::calc_params()
 }
 
 // Find ray in positive quadrant.
-// opc has been translated for this quadrant.
+// target has been translated for this quadrant; cells are translated
+// back through source and signx/signy before asking opc.
 // XXX: Allow finding ray of minimum opacity.
 static bool _find_ray_se(const coord_def& target, ray_def& ray,
-                  const opacity_func& opc, int range, bool cycle)
+                  const opacity_func& opc, const coord_def& source,
+                  int signx, int signy, int range, bool cycle)
 {
     ASSERT(target.x >= 0);
     ASSERT(target.y >= 0);
@@ -558,62 +573,43 @@ static bool _find_ray_se(const coord_def& target, ray_def& ray,
     // Ensure the precalculations have been done.
     raycast();
 
-    const vector<cellray> &min = min_cellrays(target);
-    ASSERT(!min.empty());
-    cellray c = min[0]; // XXX: const cellray &c ?
+    const vector<cellray_span> &spans = min_cellray_spans(target);
+    ASSERT(!spans.empty());
     unsigned int index = 0;
 
     if (cycle)
-        dprf("cycling from %d (total %u)", ray.cycle_idx, (unsigned int)min.size());
+    {
+        dprf("cycling from %d (total %u)", ray.cycle_idx,
+             (unsigned int)spans.size());
+    }
 
     unsigned int start = cycle ? ray.cycle_idx + 1 : 0;
-    ASSERT(start <= min.size());
+    ASSERT(start <= spans.size());
 
     int blocked = OPC_OPAQUE;
     for (unsigned int i = start;
-         (blocked >= OPC_OPAQUE) && (i < start + min.size()); i++)
+         (blocked >= OPC_OPAQUE) && (i < start + spans.size()); i++)
     {
-        index = i % min.size();
-        c = min[index];
+        index = i % spans.size();
+        const cellray_span &c = spans[index];
         blocked = OPC_CLEAR;
         // Check all inner points.
-        for (unsigned int j = 0; j < c.end && blocked < OPC_OPAQUE; j++)
-            blocked += opc(c[j]);
+        for (unsigned int j = c.start; j < c.end && blocked < OPC_OPAQUE; j++)
+        {
+            const coord_def &l = ray_coords[j];
+            blocked += opc(coord_def(source.x + signx*l.x,
+                                     source.y + signy*l.y));
+        }
     }
     if (blocked >= OPC_OPAQUE)
         return false;
 
-    ray = c.ray;
+    ray = min_cellrays(target)[index].ray;
     ray.cycle_idx = index;
 
     return true;
 }
 
-// Coordinate transformation so we can find_ray quadrant-by-quadrant.
-struct opacity_trans : public opacity_func
-{
-    const coord_def& source;
-    int signx, signy;
-    const opacity_func& orig;
-
-    opacity_trans(const opacity_func& opc, const coord_def& s, int sx, int sy)
-        : source(s), signx(sx), signy(sy), orig(opc)
-    {
-    }
-
-    CLONE(opacity_trans)
-
-    opacity_type operator()(const coord_def &l) const override
-    {
-        return orig(transform(l));
-    }
-
-    coord_def transform(const coord_def &l) const
-    {
-        return coord_def(source.x + signx*l.x, source.y + signy*l.y);
-    }
-};
-
 // Find a nonblocked ray from source to target. Return false if no
 // such ray could be found, otherwise return true and fill ray
 // appropriately.
@@ -633,9 +629,8 @@ bool find_ray(const coord_def& source, const coord_def& target,
     const int absx  = signx * (target.x - source.x);
     const int absy  = signy * (target.y - source.y);
     const coord_def abs = coord_def(absx, absy);
-    opacity_trans opc_trans = opacity_trans(opc, source, signx, signy);
 
-    if (!_find_ray_se(abs, ray, opc_trans, range, cycle))
+    if (!_find_ray_se(abs, ray, opc, source, signx, signy, range, cycle))
         return false;
 
     if (signx < 0)
@@ -530,6 +530,8 @@ static void _show_commandline_options_help()
     puts("  -test               run all test cases in test/ except test/big/");
     puts("  -test foo,bar       run only tests \"foo\" and \"bar\"");
     puts("  -test list          list available tests");
+    puts("  -perf [N]           time each Lua test N times (default 5) and");
+    puts("                      write perf-report.json");
     puts("  -script <name>      run script matching <name> in ./scripts");
 #endif
 #ifdef DEBUG_STATISTICS
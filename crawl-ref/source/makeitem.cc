@@ -494,7 +494,7 @@ static void _generate_weapon_item(item_def& item, bool allow_uniques,
                 && is_artefact(item))
             {
                 if (ego > SPWPN_NORMAL)
-                    item.props[ARTEFACT_PROPS_KEY].get_vector()[ARTP_BRAND].get_short() = ego;
+                    artefact_set_property(item, ARTP_BRAND, ego);
                 if (randart_is_bad(item)) // recheck, the brand changed
                 {
                     force_type = item.sub_type;
@@ -612,7 +612,7 @@ static void _generate_shield_item(item_def& item, bool allow_uniques,
                 && is_artefact(item))
             {
                 if (is_hybrid (item.sub_type) && ego > SPWPN_NORMAL)
-                    item.props[ARTEFACT_PROPS_KEY].get_vector()[ARTP_BRAND].get_short() = ego;
+                    artefact_set_property(item, ARTP_BRAND, ego);
                 if (randart_is_bad(item)) // recheck, the brand changed
                 {
                     force_type = item.sub_type;
@@ -1353,7 +1353,7 @@ static void _generate_armour_item(item_def& item, bool allow_uniques,
                 // best way to force an ego??
                 if (ego > SPARM_NORMAL)
                 {
-                    item.props[ARTEFACT_PROPS_KEY].get_vector()[ARTP_BRAND].get_short() = ego;
+                    artefact_set_property(item, ARTP_BRAND, ego);
                     if (randart_is_bad(item)) // recheck, the brand changed
                     {
                         force_type = item.sub_type;
@@ -210,6 +210,22 @@ struct map_cell
         _mons = new monster_info(mi);
     }
 
+    // Hand the monster_info here over to the caller, leaving none.
+    monster_info* release_monster()
+    {
+        monster_info* mi = _mons;
+        _mons = 0;
+        flags &= ~(MAP_DETECTED_MONSTER | MAP_INVISIBLE_MONSTER);
+        return mi;
+    }
+
+    // Show this monster_info here; the cell takes ownership of it.
+    void adopt_monster(monster_info* mi)
+    {
+        clear_monster();
+        _mons = mi;
+    }
+
     bool detected_monster() const
     {
         return !!(flags & MAP_DETECTED_MONSTER);
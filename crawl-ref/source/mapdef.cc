@@ -2827,6 +2827,15 @@ string map_def::validate_map_def(const depth_ranges &default_depths)
     test_lua_validate(true);
     run_lua_epilogue(true);
 
+    // The veto chunk is otherwise first compiled at placement time, on a
+    // copy of the map; compile it here so the map cache stores bytecode.
+    if (!veto.empty())
+    {
+        if (veto.load(dlua))
+            return veto.orig_error();
+        lua_pop(dlua, 1);
+    }
+
     if (!has_depth() && !lc_default_depths.empty())
         depths.add_depths(lc_default_depths);
 
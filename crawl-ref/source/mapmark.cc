@@ -962,6 +962,13 @@ string map_position_marker::debug_describe() const
 //////////////////////////////////////////////////////////////////////////
 // Map markers in env.
 
+// Whether property() can return anything but "" for this marker.
+static bool _marker_has_properties(const map_marker *marker)
+{
+    return marker->get_type() == MAT_LUA_MARKER
+           || marker->get_type() == MAT_WIZ_PROPS;
+}
+
 map_markers::map_markers() : markers(), have_inactive_markers(false)
 {
 }
@@ -1054,23 +1061,49 @@ void map_markers::activate_markers_at(coord_def p)
 
 void map_markers::add(map_marker *marker)
 {
-    markers.insert(dgn_pos_marker(marker->pos, marker));
+    link_marker(marker);
     have_inactive_markers = true;
 }
 
-void map_markers::unlink_marker(const map_marker *marker)
+void map_markers::link_marker(map_marker *marker)
 {
-    auto els = markers.equal_range(marker->pos);
+    ASSERT(marker->get_type() < NUM_MAP_MARKER_TYPES);
+    markers.insert(dgn_pos_marker(marker->pos, marker));
+    markers_by_type[marker->get_type()].insert(
+        dgn_pos_marker(marker->pos, marker));
+    if (map_bounds(marker->pos))
+        marker_cells.set(marker->pos);
+}
+
+static void _erase_marker(multimap<coord_def, map_marker *> &mmap,
+                          const map_marker *marker)
+{
+    auto els = mmap.equal_range(marker->pos);
     for (auto i = els.first; i != els.second; ++i)
     {
         if (i->second == marker)
         {
-            markers.erase(i);
+            mmap.erase(i);
             break;
         }
     }
 }
 
+void map_markers::unlink_marker(const map_marker *marker)
+{
+    _erase_marker(markers, marker);
+    _erase_marker(markers_by_type[marker->get_type()], marker);
+    if (map_bounds(marker->pos) && !markers.count(marker->pos))
+        marker_cells.set(marker->pos, false);
+}
+
+// A cheap check before searching the marker tree for a cell; most cells
+// have no markers at all.
+bool map_markers::has_markers_at(const coord_def &c) const
+{
+    return map_bounds(c) ? marker_cells(c) : markers.count(c);
+}
+
 void map_markers::check_empty()
 {
     if (markers.empty())
@@ -1087,14 +1120,12 @@ void map_markers::remove(map_marker *marker)
 void map_markers::remove_markers_at(const coord_def &c,
                                     map_marker_type type)
 {
-    auto els = markers.equal_range(c);
-    for (auto i = els.first; i != els.second;)
+    for (map_marker *marker : get_markers_at(c))
     {
-        auto todel = i++;
-        if (type == MAT_ANY || todel->second->get_type() == type)
+        if (type == MAT_ANY || marker->get_type() == type)
         {
-            delete todel->second;
-            markers.erase(todel);
+            unlink_marker(marker);
+            delete marker;
         }
     }
     check_empty();
@@ -1102,6 +1133,9 @@ void map_markers::remove_markers_at(const coord_def &c,
 
 map_marker *map_markers::find(const coord_def &c, map_marker_type type)
 {
+    if (!has_markers_at(c))
+        return nullptr;
+
     auto els = markers.equal_range(c);
     for (auto i = els.first; i != els.second; ++i)
         if (type == MAT_ANY || i->second->get_type() == type)
@@ -1111,28 +1145,17 @@ map_marker *map_markers::find(const coord_def &c, map_marker_type type)
 
 map_marker *map_markers::find(map_marker_type type)
 {
-    for (const auto &entry : markers)
-        if (type == MAT_ANY || entry.second->get_type() == type)
-            return entry.second;
-
-    return nullptr;
+    const dgn_marker_map &mmap = type == MAT_ANY ? markers
+                                                 : markers_by_type[type];
+    return mmap.empty() ? nullptr : mmap.begin()->second;
 }
 
 void map_markers::move(const coord_def &from, const coord_def &to)
 {
     unwind_bool inactive(have_inactive_markers);
-    auto els = markers.equal_range(from);
-
-    list<map_marker*> tmarkers;
-    for (auto i = els.first; i != els.second;)
-    {
-        auto curr = i++;
-        tmarkers.push_back(curr->second);
-        markers.erase(curr);
-    }
-
-    for (auto mark : tmarkers)
+    for (map_marker *mark : get_markers_at(from))
     {
+        unlink_marker(mark);
         mark->pos = to;
         add(mark);
     }
@@ -1148,12 +1171,12 @@ void map_markers::move_marker(map_marker *marker, const coord_def &to)
 
 vector<map_marker*> map_markers::get_all(map_marker_type mat)
 {
+    const dgn_marker_map &mmap = mat == MAT_ANY ? markers
+                                                : markers_by_type[mat];
     vector<map_marker*> rmarkers;
-    for (const auto &entry : markers)
-    {
-        if (mat == MAT_ANY || entry.second->get_type() == mat)
-            rmarkers.push_back(entry.second);
-    }
+    rmarkers.reserve(mmap.size());
+    for (const auto &entry : mmap)
+        rmarkers.push_back(entry.second);
     return rmarkers;
 }
 
@@ -1164,6 +1187,9 @@ vector<map_marker*> map_markers::get_all(const string &key, const string &val)
     for (const auto &entry : markers)
     {
         map_marker*  marker = entry.second;
+        if (!_marker_has_properties(marker))
+            continue;
+
         const string prop   = marker->property(key);
 
         if (val.empty() && !prop.empty() || !val.empty() && val == prop)
@@ -1175,8 +1201,11 @@ vector<map_marker*> map_markers::get_all(const string &key, const string &val)
 
 vector<map_marker*> map_markers::get_markers_at(const coord_def &c)
 {
-    auto els = markers.equal_range(c);
     vector<map_marker*> rmarkers;
+    if (!has_markers_at(c))
+        return rmarkers;
+
+    auto els = markers.equal_range(c);
     for (auto i = els.first; i != els.second; ++i)
         rmarkers.push_back(i->second);
     return rmarkers;
@@ -1185,9 +1214,15 @@ vector<map_marker*> map_markers::get_markers_at(const coord_def &c)
 string map_markers::property_at(const coord_def &c, map_marker_type type,
                                 const string &key)
 {
+    if (!has_markers_at(c))
+        return "";
+
     auto els = markers.equal_range(c);
     for (auto i = els.first; i != els.second; ++i)
     {
+        if (!_marker_has_properties(i->second))
+            continue;
+
         const string &prop = i->second->property(key);
         if (!prop.empty())
             return prop;
@@ -1200,6 +1235,9 @@ void map_markers::clear()
     for (auto &entry : markers)
         delete entry.second;
     markers.clear();
+    for (dgn_marker_map &mmap : markers_by_type)
+        mmap.clear();
+    marker_cells.reset();
     check_empty();
 }
 
@@ -1289,6 +1327,9 @@ vector<map_marker*> find_markers_by_prop(const string &prop,
     {
         for (map_marker *mark : env.markers.get_markers_at(*pos))
         {
+            if (!_marker_has_properties(mark))
+                continue;
+
             const string value(mark->property(prop));
             if (!value.empty() && (expected.empty() || value == expected))
             {
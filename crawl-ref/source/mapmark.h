@@ -61,6 +61,8 @@ public:
     virtual void write(writer &) const;
     virtual void read(reader &);
     virtual string debug_describe() const = 0;
+    // Only Lua and wizard-props markers override this; map_markers
+    // skips every other type when searching by property.
     virtual string property(const string &pname) const;
 
     static map_marker *read_marker(reader &);
@@ -240,6 +240,57 @@ struct message_line
     }
 };
 
+// A message as kept in the history. Nothing merges into a line once it is
+// stored, so its particles are joined into one string then, rather than
+// every time the history is shown, dumped or sent to webtiles.
+struct stored_message
+{
+    string              text;      // full_text() of the original line
+    msg_channel_type    channel;
+    int                 param;
+    int                 turn;
+
+    stored_message() : channel(NUM_MESSAGE_CHANNELS), param(0), turn(-1)
+    {
+    }
+
+    stored_message(const message_line &line)
+     : text(line.full_text()), channel(line.channel), param(line.param),
+       turn(line.turn)
+    {
+    }
+
+    operator bool() const
+    {
+        return channel != NUM_MESSAGE_CHANNELS;
+    }
+
+    string pure_text_with_repeats() const
+    {
+        return formatted_string::parse_string(text).tostring();
+    }
+
+    /// The text broken into lines for the message history at this width;
+    /// kept until the width changes.
+    const vector<formatted_string> &wrapped(int width) const
+    {
+        if (width != wrap_width)
+        {
+            string wrap_text = text;
+            linebreak_string(wrap_text, width);
+            wrapped_parts.clear();
+            formatted_string::parse_string_to_multiple(wrap_text,
+                                                       wrapped_parts, 80);
+            wrap_width = width;
+        }
+        return wrapped_parts;
+    }
+
+private:
+    mutable vector<formatted_string> wrapped_parts;
+    mutable int wrap_width = -1;
+};
+
 static int _mod(int num, int denom)
 {
     ASSERT(denom > 0);
@@ -328,7 +379,7 @@ public:
      * Append the contents of `buf` to the current buffer.
      * If `buf` has cycled, this will overwrite the entire contents of `this`.
      */
-    void append(const circ_vec<T, SIZE> buf)
+    void append(const circ_vec<T, SIZE> &buf)
     {
         const int buf_size = buf.filled_size();
         for (int i = 0; i < buf_size; i++)
@@ -745,7 +796,7 @@ bool any_messages()
     return msgwin.any_messages();
 }
 
-typedef circ_vec<message_line, NUM_STORED_MESSAGES> store_t;
+typedef circ_vec<stored_message, NUM_STORED_MESSAGES> store_t;
 
 class message_store
 {
@@ -795,9 +846,10 @@ public:
 #endif
     }
 
-    void store_msg(const message_line& msg)
+    void store_msg(const message_line& line)
     {
         prefix_type p = prefix_type::none;
+        const stored_message msg(line);
         msgs.push_back(msg);
         if (_temporary)
             temp++;
@@ -809,7 +861,7 @@ public:
         unwind_bool dontsend(send_ignore_one, true);
 #endif
         if (crawl_state.io_inited && crawl_state.game_started)
-            msgwin.add_item(msg.full_text(), p, _temporary);
+            msgwin.add_item(msg.text, p, _temporary);
     }
 
     void roll_back()
@@ -861,7 +913,7 @@ public:
         return msgs;
     }
 
-    void append_store(store_t store)
+    void append_store(const store_t &store)
     {
         msgs.append(store);
         const int msgs_to_print = store.filled_size();
@@ -869,7 +921,7 @@ public:
         unwind_bool dontsend(send_ignore_one, true);
 #endif
         for (int i = 0; i < msgs_to_print; i++)
-            msgwin.add_item(msgs[i - msgs_to_print].full_text(), prefix_type::none, false);
+            msgwin.add_item(msgs[i - msgs_to_print].text, prefix_type::none, false);
     }
 
     void clear()
@@ -896,9 +948,9 @@ public:
         tiles.json_open_array("messages");
         for (int i = -unsent; i < (send_ignore_one ? -1 : 0); ++i)
         {
-            message_line& msg = msgs[i];
+            const stored_message& msg = msgs[i];
             tiles.json_open_object();
-            tiles.json_write_string("text", msg.full_text());
+            tiles.json_write_string("text", msg.text);
             tiles.json_write_int("turn", msg.turn);
             tiles.json_write_int("channel", msg.channel);
             tiles.json_close_object();
@@ -944,6 +996,8 @@ static bool suppress_messages = false;
 static msg_colour_type prepare_message(const string& imsg,
                                        msg_channel_type channel,
                                        int param);
+static bool _message_discarded(msg_channel_type channel);
+static void _flush_comes_into_view();
 
 static unordered_set<message_tee *> current_message_tees;
 
@@ -1162,6 +1216,13 @@ int channel_to_colour(msg_channel_type channel, int param)
 void do_message_print(msg_channel_type channel, int param, bool cap,
                              bool nojoin, const char *format, va_list argp)
 {
+    // Inside no_messages most messages go nowhere; don't format them.
+    if (_message_discarded(channel))
+    {
+        _flush_comes_into_view();
+        return;
+    }
+
     va_list ap;
     va_copy(ap, argp);
     char buff[200];
@@ -1271,25 +1332,122 @@ void dprf(diag_type param, const char *format, ...)
 
 static bool _updating_view = false;
 
+// Flush out any "comes into view" monster announcements before the
+// monster has a chance to give any other messages.
+static void _flush_comes_into_view()
+{
+    if (!_updating_view && crawl_state.io_inited)
+    {
+        _updating_view = true;
+        flush_comes_into_view();
+        _updating_view = false;
+    }
+}
+
+// Would _mpr() drop a message on this channel without any other effect?
+// Before IO is set up, muted messages still go to the buffer and tees.
+static bool _message_discarded(msg_channel_type channel)
+{
+    return suppress_messages && crawl_state.io_inited
+           && channel != MSGCH_ERROR && channel != MSGCH_PROMPT
+           && !_msg_dump_file && !_msgs_to_stderr
+           && !crawl_state.game_crashed
+           && !(crawl_state.game_is_valid_type()
+                && crawl_state.game_is_arena());
+}
+
+// The filters of one message option that can apply to a given channel.
+struct channel_filters
+{
+    bool always = false;    // A filter with no pattern matches everything.
+    vector<const text_pattern *> patterns;
+
+    bool matches(const string &line) const
+    {
+        return always
+               || any_of(patterns.begin(), patterns.end(),
+                         [&line](const text_pattern *p)
+                         { return p->matches(line); });
+    }
+};
+
+// force_more_message, flash_screen_message and message_colour split up by
+// channel, so that each message only tries the patterns that could apply
+// to it. Rebuilt on first use after the options change.
+static struct
+{
+    bool valid = false;
+    channel_filters more[NUM_MESSAGE_CHANNELS];
+    channel_filters flash[NUM_MESSAGE_CHANNELS];
+    vector<const message_colour_mapping *> colours[NUM_MESSAGE_CHANNELS];
+} _option_filters;
+
+void invalidate_message_filters()
+{
+    _option_filters.valid = false;
+}
+
+static void _split_filters(const vector<message_filter> &option,
+                           channel_filters (&by_channel)[NUM_MESSAGE_CHANNELS])
+{
+    for (int ch = 0; ch < NUM_MESSAGE_CHANNELS; ++ch)
+    {
+        channel_filters &filters = by_channel[ch];
+        filters.always = false;
+        filters.patterns.clear();
+        for (const message_filter &mf : option)
+        {
+            if (mf.channel != ch && mf.channel != -1)
+                continue;
+            if (mf.pattern.empty())
+            {
+                filters.always = true;
+                filters.patterns.clear();
+                break;
+            }
+            filters.patterns.push_back(&mf.pattern);
+        }
+    }
+}
+
+static void _build_option_filters()
+{
+    if (_option_filters.valid)
+        return;
+
+    _split_filters(Options.force_more_message, _option_filters.more);
+    _split_filters(Options.flash_screen_message, _option_filters.flash);
+    for (int ch = 0; ch < NUM_MESSAGE_CHANNELS; ++ch)
+    {
+        _option_filters.colours[ch].clear();
+        for (const message_colour_mapping &mcm
+             : Options.message_colour_mappings)
+        {
+            if (mcm.message.channel == ch || mcm.message.channel == -1)
+                _option_filters.colours[ch].push_back(&mcm);
+        }
+    }
+    _option_filters.valid = true;
+}
+
 static bool _check_option(const string& line, msg_channel_type channel,
-                          const vector<message_filter>& option)
+                          const channel_filters
+                              (&option)[NUM_MESSAGE_CHANNELS])
 {
     if (crawl_state.generating_level)
         return false;
-    return any_of(begin(option),
-                  end(option),
-                  bind(mem_fn(&message_filter::is_filtered),
-                       placeholders::_1, channel, line));
+    _build_option_filters();
+    return option[channel].matches(line);
 }
 
 static bool _check_more(const string& line, msg_channel_type channel)
 {
-    return _check_option(line, channel, Options.force_more_message);
+    return _check_option(line, channel, _option_filters.more);
 }
 
 static bool _check_flash_screen(const string& line, msg_channel_type channel)
 {
-    return _check_option(line, channel, Options.flash_screen_message);
+    return _check_option(line, channel, _option_filters.flash);
 }
 
 static bool _check_join(const string& line, msg_channel_type channel)
@@ -1425,14 +1583,7 @@ static void _mpr(string text, msg_channel_type channel, int param, bool nojoin,
         fprintf(stderr, "%s\n", text.c_str());
     }
 
-    // Flush out any "comes into view" monster announcements before the
-    // monster has a chance to give any other messages.
-    if (!_updating_view && crawl_state.io_inited)
-    {
-        _updating_view = true;
-        flush_comes_into_view();
-        _updating_view = false;
-    }
+    _flush_comes_into_view();
 
     if (channel == MSGCH_GOD && param == 0)
         param = you.religion;
@@ -1707,11 +1858,13 @@ static msg_colour_type prepare_message(const string& imsg,
 
     if (!crawl_state.generating_level)
     {
-        for (const message_colour_mapping &mcm : Options.message_colour_mappings)
+        _build_option_filters();
+        for (const message_colour_mapping *mcm
+             : _option_filters.colours[channel])
         {
-            if (mcm.message.is_filtered(channel, imsg))
+            if (mcm->message.is_filtered(channel, imsg))
             {
-                colour = mcm.colour;
+                colour = mcm->colour;
                 break;
             }
         }
@@ -2053,7 +2206,7 @@ string get_last_messages(int mcount, bool full)
     mcount = min(mcount, NUM_STORED_MESSAGES);
     for (int i = -1; mcount > 0; --i)
     {
-        const message_line msg = msgs[i];
+        const stored_message &msg = msgs[i];
         if (!msg)
             break;
         if (full || is_channel_dumpworthy(msg.channel))
@@ -2082,7 +2235,7 @@ void get_recent_messages(vector<string> &mess,
     int mcount = NUM_STORED_MESSAGES;
     for (int i = -1; mcount > 0; --i, --mcount)
     {
-        const message_line msg = msgs[i];
+        const stored_message &msg = msgs[i];
         if (!msg)
             break;
         mess.push_back(msg.pure_text_with_repeats());
@@ -2100,7 +2253,7 @@ bool recent_error_messages()
     int mcount = NUM_STORED_MESSAGES;
     for (int i = -1; mcount > 0; --i, --mcount)
     {
-        const message_line msg = msgs[i];
+        const stored_message &msg = msgs[i];
         if (!msg)
             break;
         if (msg.channel == MSGCH_ERROR)
@@ -2113,11 +2266,11 @@ bool recent_error_messages()
 // messages. They'll be ignored when restoring.
 void save_messages(writer& outf)
 {
-    store_t msgs = buffer.get_store();
+    const store_t &msgs = buffer.get_store();
     marshallInt(outf, msgs.size());
     for (int i = 0; i < msgs.size(); ++i)
     {
-        marshallString4(outf, msgs[i].full_text());
+        marshallString4(outf, msgs[i].text);
         marshallInt(outf, msgs[i].channel);
         marshallInt(outf, msgs[i].param);
         marshallInt(outf, msgs[i].turn);
@@ -2160,15 +2313,13 @@ static void _replay_messages_core(formatted_scroller &hist)
 {
     flush_prev_message();
 
-    const store_t msgs = buffer.get_store();
+    const store_t &msgs = buffer.get_store();
+    const int width = cgetsize(GOTO_CRT).x - 1;
     formatted_string lines;
     for (int i = 0; i < msgs.size(); ++i)
         if (channel_message_history(msgs[i].channel))
         {
-            string text = msgs[i].full_text();
-            linebreak_string(text, cgetsize(GOTO_CRT).x - 1);
-            vector<formatted_string> parts;
-            formatted_string::parse_string_to_multiple(text, parts, 80);
+            const vector<formatted_string> &parts = msgs[i].wrapped(width);
             for (unsigned int j = 0; j < parts.size(); ++j)
             {
                 prefix_type p = prefix_type::none;
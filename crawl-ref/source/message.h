@@ -141,6 +141,9 @@ void get_recent_messages(vector<string> &messages,
 bool recent_error_messages();
 
 int channel_to_colour(msg_channel_type channel, int param = 0);
+
+// Call whenever a message option (force_more_message etc.) may have changed.
+void invalidate_message_filters();
 bool strip_channel_prefix(string &text, msg_channel_type &channel,
                           bool silence = false);
 
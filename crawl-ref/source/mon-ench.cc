@@ -131,7 +131,10 @@ void monster::update_ench(const mon_enchant &ench)
     if (ench.ench != ENCH_NONE)
     {
         if (mon_enchant *curr_ench = map_find(enchantments, ench.ench))
+        {
             *curr_ench = ench;
+            changed_info();
+        }
     }
 }
 
@@ -169,6 +172,8 @@ bool monster::add_ench(const mon_enchant &ench)
             props[ORIGINAL_TYPE_KEY].get_int() = MONS_GLOWING_SHAPESHIFTER;
     }
 
+    changed_info();
+
     bool new_enchantment = false;
     mon_enchant *added = map_find(enchantments, ench.ench);
     if (added)
@@ -429,6 +434,7 @@ bool monster::del_ench(enchant_type ench, bool quiet, bool effect)
 
     enchantments.erase(et);
     ench_cache.set(et, false);
+    changed_info();
     if (effect)
         remove_enchantment_effect(me, quiet);
     return true;
@@ -2080,11 +2086,19 @@ void monster::apply_enchantments()
     // or remove others -- or even itself.
     FixedBitVector<NUM_ENCHANTMENTS> ec = ench_cache;
 
+    // Only visit the enchantments the monster actually has, rather than
+    // every enchant_type. The map is kept in enchant_type order, so each
+    // step looks up the next key from the one just handled, which stays
+    // valid however the map changed underneath us.
     // The ordering in enchant_type makes sure that "super-enchantments"
     // like berserk time out before their parts.
-    for (int i = 0; i < NUM_ENCHANTMENTS; ++i)
-        if (ec[i] && has_ench(static_cast<enchant_type>(i)))
-            apply_enchantment(enchantments.find(static_cast<enchant_type>(i))->second);
+    for (auto it = enchantments.begin(); it != enchantments.end();)
+    {
+        const enchant_type et = it->first;
+        if (ec[et] && has_ench(et))
+            apply_enchantment(it->second);
+        it = enchantments.upper_bound(et);
+    }
 }
 
 // Used to adjust time durations in calc_duration() for monster speed.
@@ -21,6 +21,7 @@
 #include "fight.h"
 #include "god-abil.h"
 #include "ghost.h"
+#include "hash.h"
 #include "item-name.h"
 #include "item-prop.h"
 #include "item-status-flag-type.h"
@@ -38,6 +39,7 @@
 #include "spl-summoning.h"
 #include "state.h"
 #include "stringutil.h"
+#include "tags.h"
 #ifdef USE_TILE
 #include "tilepick.h"
 #endif
@@ -1834,12 +1836,177 @@ void get_monster_info(vector<monster_info>& mons)
         if (mons_is_threatening(*mon)
             || mon->is_child_tentacle())
         {
-            mons.emplace_back(mon);
+            mons.push_back(cached_monster_info(mon));
         }
     }
     sort(mons.begin(), mons.end(), monster_info::less_than_wrapper);
 }
 
+// Props are written directly all over the place, so hash what a save would
+// record of them.
+static uint32_t _props_hash(const CrawlHashTable &props)
+{
+    if (props.empty())
+        return 0;
+    vector<unsigned char> buf;
+    writer outf(&buf);
+    props.write(outf);
+    return hash32(buf.data(), buf.size());
+}
+
+// What a cached monster_info was built from. The monster's info_version
+// covers changes made through its methods (enchantments and so on); the rest
+// are fields that code all over the place changes directly, plus the parts
+// of the player's state that monster_info depends on.
+struct mon_info_key
+{
+    mid_t mid = 0;
+    uint32_t client_id = 0;
+    uint32_t version = 0;
+    uint32_t epoch = 0;
+    coord_def pos;
+    coord_def you_pos;
+    int xl = 0;
+    bool you_invisible = false;
+    bool you_see_invis = false;
+    int hp = 0;
+    int max_hp = 0;
+    int hd = 0;
+    monster_type type = MONS_NO_MONSTER;
+    monster_type base_type = MONS_NO_MONSTER;
+    mon_attitude_type attitude = ATT_HOSTILE;
+    beh_type behaviour = BEH_SLEEP;
+    int foe = 0;
+    int colour = 0;
+    int number = 0;
+    int ballisto_activity = 0;
+    monster_flags_t flags;
+    uint32_t inv = 0;
+    uint32_t props = 0;
+    unsigned int beholders = 0;
+    mid_t constricted_by = 0;
+    unsigned int constricting = 0;
+
+    mon_info_key() {}
+
+    mon_info_key(const monster &m, uint32_t epoch_)
+        : mid(m.mid), client_id(m.get_client_id()),
+          version(m.info_version), epoch(epoch_),
+          pos(m.pos()), you_pos(you.pos()), xl(you.experience_level),
+          you_invisible(you.invisible()),
+          you_see_invis(you.can_see_invisible()), hp(m.hit_points),
+          max_hp(m.max_hit_points), hd(m.get_hit_dice()), type(m.type),
+          base_type(m.base_monster), attitude(m.attitude),
+          behaviour(m.behaviour), foe(m.foe), colour(m.colour),
+          number(m.number), ballisto_activity(m.ballisto_activity),
+          flags(m.flags), props(_props_hash(m.props)),
+          beholders(you.beholders.size()), constricted_by(m.constricted_by),
+          constricting(m.constricting ? m.constricting->size() : 0)
+    {
+        // Items can be picked up, dropped or identified behind our back.
+        inv = hash32(&m.inv, sizeof(m.inv));
+        for (short idx : m.inv)
+            if (idx != NON_ITEM)
+                inv = inv * 31 + (uint32_t) mitm[idx].flags;
+    }
+
+    bool operator == (const mon_info_key &o) const
+    {
+        return mid == o.mid && client_id == o.client_id
+               && version == o.version && epoch == o.epoch
+               && pos == o.pos && you_pos == o.you_pos && xl == o.xl
+               && you_invisible == o.you_invisible
+               && you_see_invis == o.you_see_invis
+               && hp == o.hp && max_hp == o.max_hp
+               && hd == o.hd && type == o.type && base_type == o.base_type
+               && attitude == o.attitude && behaviour == o.behaviour
+               && foe == o.foe && colour == o.colour && number == o.number
+               && ballisto_activity == o.ballisto_activity
+               && flags == o.flags && inv == o.inv && props == o.props
+               && beholders == o.beholders
+               && constricted_by == o.constricted_by
+               && constricting == o.constricting;
+    }
+};
+
+struct mon_info_cache_entry
+{
+    mon_info_key key;
+    unique_ptr<monster_info> info;
+};
+
+static mon_info_cache_entry mon_info_cache[MAX_MONSTERS];
+// Bumped for changes to the surroundings of all monsters (areas, terrain,
+// clouds) or to the player's item knowledge that monster_info looks at.
+static uint32_t mon_info_epoch = 0;
+// Numbers each snapshot built, so copies of it can be recognised.
+static uint32_t mon_info_snapshots = 0;
+
+#ifdef DEBUG
+// Does a cached snapshot still show what a fresh one would?
+static bool _same_monster_info(const monster_info &a, const monster_info &b)
+{
+    for (int i = 0; i < NUM_MB_FLAGS; ++i)
+        if (a.mb[i] != b.mb[i])
+            return false;
+    return a.pos == b.pos && a.mname == b.mname && a.type == b.type
+           && a.base_type == b.base_type && a.number == b.number
+           && a._colour == b._colour && a.attitude == b.attitude
+           && a.threat == b.threat && a.dam == b.dam
+           && a.fire_blocker == b.fire_blocker
+           && a.description == b.description && a.quote == b.quote
+           && a.holi == b.holi && a.mintel == b.mintel && a.hd == b.hd
+           && a.ac == b.ac && a.ev == b.ev && a.base_ev == b.base_ev
+           && a.mr == b.mr && a.mresists == b.mresists
+           && a.can_see_invis == b.can_see_invis
+           && a.mitemuse == b.mitemuse && a.mbase_speed == b.mbase_speed
+           && a.constrictor_name == b.constrictor_name
+           && a.constricting_name == b.constricting_name
+           && a.client_id == b.client_id
+           && a.full_name(DESC_PLAIN) == b.full_name(DESC_PLAIN);
+}
+#endif
+
+/**
+ * Get a monster_info for a monster, reusing the one built by the previous
+ * call for the same monster if nothing it depends on has changed since.
+ * Redraws call this for every visible monster, and with a crowded LOS
+ * building them from scratch each time is expensive.
+ *
+ * @param m     The monster; must be in menv.
+ * @return      A snapshot valid until the next call for the same monster.
+ */
+const monster_info &cached_monster_info(const monster* m)
+{
+    ASSERT(m);
+    ASSERT_RANGE(m->mindex(), 0, MAX_MONSTERS);
+
+    mon_info_cache_entry &entry = mon_info_cache[m->mindex()];
+    const mon_info_key key(*m, mon_info_epoch);
+    if (!entry.info || !(entry.key == key))
+    {
+        entry.info.reset(new monster_info(m));
+        entry.info->snapshot = ++mon_info_snapshots;
+        entry.key = key;
+    }
+#ifdef DEBUG
+    // Catch anything that changes what a monster looks like without
+    // touching the key.
+    else
+    {
+        ASSERTM(_same_monster_info(*entry.info, monster_info(m)),
+                "stale monster_info for %s", m->name(DESC_PLAIN).c_str());
+    }
+#endif
+    return *entry.info;
+}
+
+/// Make every cached_monster_info() rebuild its snapshot.
+void invalidate_monster_info_cache()
+{
+    ++mon_info_epoch;
+}
+
 monster_type monster_info::draco_or_demonspawn_subspecies() const
 {
     if (type == MONS_PLAYER_ILLUSION && mons_genus(type) == MONS_DRACONIAN)
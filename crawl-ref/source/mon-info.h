@@ -221,6 +221,9 @@ struct monster_info_base
     mon_attack_def attack[MAX_NUM_ATTACKS];
 
     uint32_t client_id;
+    // Which cached_monster_info() snapshot this is a copy of, if any; not
+    // saved.
+    uint32_t snapshot = 0;
 };
 
 // Monster info used by the pane; precomputes some data
@@ -388,4 +391,7 @@ void clear_monster_list_colours();
 
 void get_monster_info(vector<monster_info>& mons);
 
+const monster_info &cached_monster_info(const monster* m);
+void invalidate_monster_info_cache();
+
 typedef function<vector<string> (const monster_info& mi)> (desc_filter);
@@ -10,6 +10,7 @@
 
 #include <algorithm>
 #include <functional>
+#include <queue>
 
 #include "abyss.h"
 #include "areas.h"
@@ -863,18 +864,54 @@ monster* place_monster(mgen_data mg, bool force_pos, bool dont_place)
     return mon;
 }
 
-monster* get_free_monster()
+// Candidate free menv slots, lowest first; see _free_item_slots in items.cc.
+// monster::reset() pushes the slot of every menv monster it clears.
+static priority_queue<int, vector<int>, greater<int>> _free_monster_slots;
+
+void rebuild_free_monster_slots()
+{
+    vector<int> slots;
+    for (int i = 0; i < MAX_MONSTERS; ++i)
+        if (menv[i].type == MONS_NO_MONSTER)
+            slots.push_back(i);
+
+    _free_monster_slots = priority_queue<int, vector<int>, greater<int>>(
+                              greater<int>(), move(slots));
+}
+
+void release_monster_slot(int mindex)
+{
+    ASSERT_RANGE(mindex, 0, MAX_MONSTERS);
+    if (_free_monster_slots.size() > 2 * MAX_MONSTERS)
+        rebuild_free_monster_slots();
+    else
+        _free_monster_slots.push(mindex);
+}
+
+static monster* _pop_free_monster()
 {
-    for (auto &mons : menv_real)
+    while (!_free_monster_slots.empty())
+    {
+        monster &mons = menv[_free_monster_slots.top()];
+        _free_monster_slots.pop();
         if (mons.type == MONS_NO_MONSTER)
         {
-            mons.reset();
+            mons.reset_fields();
             return &mons;
         }
-
+    }
     return nullptr;
 }
 
+monster* get_free_monster()
+{
+    if (monster* mons = _pop_free_monster())
+        return mons;
+
+    rebuild_free_monster_slots();
+    return _pop_free_monster();
+}
+
 void mons_add_blame(monster* mon, const string &blame_string)
 {
     const bool exists = mon->props.exists("blame");
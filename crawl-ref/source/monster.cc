@@ -78,7 +78,7 @@ monster::monster()
       enchantments(), flags(), xp_tracking(XP_NON_VAULT), experience(0),
       base_monster(MONS_NO_MONSTER), number(0), colour(COLOUR_INHERIT),
       foe_memory(0), god(GOD_NO_GOD), ghost(), seen_context(SC_NONE),
-      client_id(0), hit_dice(0)
+      client_id(0), info_version(0), hit_dice(0)
 
 {
     type = MONS_NO_MONSTER;
@@ -114,6 +114,15 @@ monster &monster::operator = (const monster& mon)
 }
 
 void monster::reset()
+{
+    reset_fields();
+
+    // Let get_free_monster() find the slot again.
+    if (this >= &menv[0] && this < &menv[0] + MAX_MONSTERS)
+        release_monster_slot(mindex());
+}
+
+void monster::reset_fields()
 {
     mname.clear();
     enchantments.clear();
@@ -159,6 +168,7 @@ void monster::reset()
     ASSERT(!constricting);
 
     client_id = 0;
+    changed_info();
 
     // Just for completeness.
     speed           = 0;
@@ -167,7 +177,7 @@ void monster::reset()
 
 void monster::init_with(const monster& mon)
 {
-    reset();
+    reset_fields();
 
     mid               = mon.mid;
     mname             = mon.mname;
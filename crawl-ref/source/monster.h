@@ -47,7 +47,10 @@ public:
     ~monster();
 
     monster& operator = (const monster& other);
+    // Empty the monster, and give its menv slot back to get_free_monster().
     void reset();
+    // Empty the monster, leaving its slot taken (to fill it straight away).
+    void reset_fields();
 
 public:
     // Possibly some of these should be moved into the hash table
@@ -112,6 +115,9 @@ public:
     uint32_t client_id;                // for ID of monster_info between turns
     static uint32_t last_client_id;
 
+    uint32_t info_version;             // bumped when cached_monster_info()
+                                       // needs to be rebuilt; not saved
+
     bool went_unseen_this_turn;
     coord_def unseen_pos;
 
@@ -122,6 +128,8 @@ public:
     void reset_client_id();
     void ensure_has_client_id();
 
+    void changed_info() { ++info_version; }
+
     void set_hit_dice(int new_hd);
 
     mon_attitude_type temp_attitude() const override;
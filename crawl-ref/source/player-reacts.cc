@@ -842,9 +842,16 @@ static void _decrement_durations()
     }
 
     // these should be after decr_ambrosia, transforms, liquefying, etc.
+    // Inactive durations are skipped before looking up their data, which
+    // would also roll their midpoint fuzz for nothing.
     for (int i = 0; i < NUM_DURATIONS; ++i)
-        if (duration_decrements_normally((duration_type) i))
+    {
+        if (you.duration[i]
+            && duration_decrements_normally((duration_type) i))
+        {
             _decrement_simple_duration((duration_type) i, delay);
+        }
+    }
 }
 
 /**
@@ -5,6 +5,10 @@
 
 #pragma once
 
+#include <algorithm>
+#include <map>
+#include <vector>
+
 #include "random.h"
 
 enum distrib_type
@@ -27,6 +31,15 @@ struct random_pick_entry
     T value;
 };
 
+// The entries of a weight list that can appear at one level, with their
+// running rarity totals.
+template <typename T>
+struct random_pick_table
+{
+    vector<T> values;
+    vector<int> totals;
+};
+
 template <typename T, int max>
 class random_picker
 {
@@ -37,6 +50,13 @@ public:
     int rarity_at(const random_pick_entry<T> *pop,
                   int depth);
     virtual bool veto(T val) { return false; }
+    // Whether veto() might reject anything; subclasses overriding veto()
+    // must override this too, or their vetoes will be skipped.
+    virtual bool has_veto() const { return false; }
+
+private:
+    const random_pick_table<T> &table_at(const random_pick_entry<T> *weights,
+                                         int level);
 };
 
 template <typename T, int max>
@@ -44,26 +64,66 @@ random_picker<T, max>::~random_picker()
 {
 }
 
+// Weight lists are static tables, so the entries valid at each level are
+// worked out once and kept for the rest of the game.
 template <typename T, int max>
-T random_picker<T, max>::pick(const random_pick_entry<T> *weights, int level,
-                              T none)
+const random_pick_table<T> &random_picker<T, max>::table_at(
+    const random_pick_entry<T> *weights, int level)
 {
-    struct { T value; int rarity; } valid[max];
-    int nvalid = 0;
-    int totalrar = 0;
+    static map<pair<const random_pick_entry<T> *, int>,
+               random_pick_table<T>> tables;
+
+    auto found = tables.find(make_pair(weights, level));
+    if (found != tables.end())
+        return found->second;
 
+    random_pick_table<T> &table = tables[make_pair(weights, level)];
+    int totalrar = 0;
     for (const random_pick_entry<T> *pop = weights; pop->rarity; pop++)
     {
         if (level < pop->minr || level > pop->maxr)
             continue;
 
-        if (veto(pop->value))
-            continue;
-
         int rar = rarity_at(pop, level);
         ASSERTM(rar > 0, "Rarity %d: %d at level %d", rar, pop->value, level);
 
-        valid[nvalid].value = pop->value;
+        totalrar += rar;
+        table.values.push_back(pop->value);
+        table.totals.push_back(totalrar);
+    }
+    return table;
+}
+
+template <typename T, int max>
+T random_picker<T, max>::pick(const random_pick_entry<T> *weights, int level,
+                              T none)
+{
+    const random_pick_table<T> &table = table_at(weights, level);
+    if (table.values.empty())
+        return none;
+
+    // Without a veto, the roll can go straight to the table. Either way
+    // exactly one roll is made over the same entries in the same order, so
+    // the results are the same as they always were for a given seed.
+    if (!has_veto())
+    {
+        const int roll = random2(table.totals.back());
+        const auto it = upper_bound(table.totals.begin(), table.totals.end(),
+                                    roll);
+        return table.values[it - table.totals.begin()];
+    }
+
+    struct { T value; int rarity; } valid[max];
+    int nvalid = 0;
+    int totalrar = 0;
+
+    for (size_t i = 0; i < table.values.size(); i++)
+    {
+        if (veto(table.values[i]))
+            continue;
+
+        const int rar = table.totals[i] - (i ? table.totals[i - 1] : 0);
+        valid[nvalid].value = table.values[i];
         valid[nvalid].rarity = rar;
         totalrar += rar;
         nvalid++;
@@ -420,7 +420,7 @@ static void _handle_unseen_mons(monster* mons, uint32_t hash_ind)
  * be upated with a disturbance if necessary.
  * @param mons  The monster at the relevant location.
 **/
-static void _update_monster(monster* mons)
+static void _update_monster(monster* mons, unique_ptr<monster_info> &shown)
 {
     _check_monster_pos(mons);
     const coord_def gp = mons->pos();
@@ -428,8 +428,12 @@ static void _update_monster(monster* mons)
     if (mons->visible_to(&you))
     {
         mons->ensure_has_client_id();
-        monster_info mi(mons);
-        env.map_knowledge(gp).set_monster(mi);
+        const monster_info &mi = cached_monster_info(mons);
+        // Keep the copy already shown here if it is of the same snapshot.
+        if (shown && shown->snapshot == mi.snapshot)
+            env.map_knowledge(gp).adopt_monster(shown.release());
+        else
+            env.map_knowledge(gp).set_monster(mi);
         return;
     }
 
@@ -492,12 +496,15 @@ static void _update_monster(monster* mons)
 **/
 void show_update_at(const coord_def &gp, layers_type layers)
 {
-    if (you.see_cell(gp))
-        env.map_knowledge(gp).clear_data();
-    else if (!env.map_knowledge(gp).known())
+    const bool seen = you.see_cell(gp);
+    if (!seen && !env.map_knowledge(gp).known())
         return;
-    else
-        env.map_knowledge(gp).clear_monster();
+
+    // Set aside the monster shown here, in case it can be shown again
+    // without copying.
+    unique_ptr<monster_info> shown(env.map_knowledge(gp).release_monster());
+    if (seen)
+        env.map_knowledge(gp).clear_data();
     // The sequence is grid, items, clouds, monsters.
     _update_feat_at(gp);
 
@@ -509,7 +516,7 @@ void show_update_at(const coord_def &gp, layers_type layers)
         {
             monster* mons = monster_at(gp);
             if (mons && mons->alive())
-                _update_monster(mons);
+                _update_monster(mons, shown);
             else if (env.map_knowledge(gp).flags & MAP_INVISIBLE_UPDATE)
                 _mark_invisible_at(gp);
         }
@@ -21,6 +21,7 @@ public:
                               spell_pick_vetoer veto_func = nullptr);
 
     virtual bool veto(spell_type spell) override;
+    virtual bool has_veto() const override { return veto_func != nullptr; }
 
 protected:
     spell_pick_vetoer veto_func;
@@ -24,6 +24,7 @@
 #include "files.h"
 #include "feature.h"
 #include "god-passive.h"
+#include "hash.h"
 #include "hints.h"
 #include "invent.h"
 #include "item-prop.h"
@@ -170,7 +171,7 @@ static void _fully_identify_item(item_def *item)
 // Stash
 // ----------------------------------------------------------------------
 
-Stash::Stash(coord_def pos_) : items()
+Stash::Stash(coord_def pos_) : items(), search_text(), search_text_gen(-1)
 {
     // First, fix what square we're interested in
     if (pos_.origin())
@@ -250,6 +251,8 @@ bool Stash::unmark_trapping_nets()
     for (auto &item : items)
         if (item_is_stationary_net(item))
             item.net_placed = false, changed = true;
+    if (changed)
+        invalidate_search_text();
     return changed;
 }
 
@@ -278,6 +281,7 @@ void Stash::update()
     {
         // Zap existing items
         items.clear();
+        invalidate_search_text();
 
         // Now, grab all items on that square and fill our vector
         for (stack_iterator si(pos, true); si; ++si)
@@ -294,6 +298,8 @@ void Stash::update()
     {
         if (!_grid_has_perceived_item(pos))
         {
+            if (!items.empty())
+                invalidate_search_text();
             items.clear();
             verified = true;
             return;
@@ -307,8 +313,11 @@ void Stash::update()
         maybe_identify_base_type(*pitem);
         const item_def& item = *pitem;
 
-        if (!_grid_has_perceived_multiple_items(pos))
+        if (!_grid_has_perceived_multiple_items(pos) && !items.empty())
+        {
             items.clear();
+            invalidate_search_text();
+        }
 
         // We knew of nothing on this square, so we'll assume this is the
         // only item here, but mark it as unverified unless we can see nothing
@@ -349,6 +358,7 @@ void Stash::update()
                 {
                     // Found it. Swap it to the front of the vector.
                     swap(items[i], items[0]);
+                    invalidate_search_text();
 
                     // We don't set verified to true. If this stash was
                     // already unverified, it remains so.
@@ -453,18 +463,18 @@ vector<stash_search_result> Stash::matches_search(
     if (empty())
         return results;
 
-    for (const item_def &item : items)
+    const vector<stash_search_text> &text = get_search_text();
+    for (int i = 0, count = items.size(); i < count; ++i)
     {
-        const string s   = stash_item_name(item);
-        const string ann = stash_annotate_item(STASH_LUA_SEARCH_ANNOTATE, &item);
-        if (search.matches(prefix + " " + ann + " " + s)
-            || is_dumpable_artefact(item) && search.matches(chardump_desc(item)))
+        const stash_search_text &t = text[i];
+        if (search.matches(prefix + " " + t.annotation + " " + t.name)
+            || !t.artefact.empty() && search.matches(t.artefact))
         {
             stash_search_result res;
             res.match_type = MATCH_ITEM;
-            res.match = s;
-            res.primary_sort = item.name(DESC_QUALNAME);
-            res.item = item;
+            res.match = t.name;
+            res.primary_sort = t.qualname;
+            res.item = items[i];
             results.push_back(res);
         }
     }
@@ -490,6 +500,28 @@ vector<stash_search_result> Stash::matches_search(
     return results;
 }
 
+// Returns the search text for items, rebuilding it if the pile or the
+// global search generation changed since it was last built.
+const vector<stash_search_text> &Stash::get_search_text() const
+{
+    if (search_text_gen == StashTrack.search_text_generation())
+        return search_text;
+
+    search_text.clear();
+    for (const item_def &item : items)
+    {
+        stash_search_text t;
+        t.name = stash_item_name(item);
+        t.qualname = item.name(DESC_QUALNAME);
+        t.annotation = stash_annotate_item(STASH_LUA_SEARCH_ANNOTATE, &item);
+        if (is_dumpable_artefact(item))
+            t.artefact = chardump_desc(item);
+        search_text.push_back(t);
+    }
+    search_text_gen = StashTrack.search_text_generation();
+    return search_text;
+}
+
 /// Fedhas: rot away all corpses.
 void Stash::rot_all_corpses()
 {
@@ -497,7 +529,10 @@ void Stash::rot_all_corpses()
     {
         item_def &item = items[i];
         if (item.is_type(OBJ_CORPSES, CORPSE_BODY) && item.stash_freshness >= 0)
+        {
             item.stash_freshness = -1;
+            invalidate_search_text();
+        }
     }
 }
 
@@ -510,6 +545,9 @@ void Stash::_update_corpses(int rot_time)
         if (!_is_rottable(item))
             continue;
 
+        // Rotting changes the "(gone by now)" and similar suffixes.
+        invalidate_search_text();
+
         int new_rot = static_cast<int>(item.stash_freshness) - rot_time;
 
         if (new_rot <= _min_rot(item))
@@ -525,8 +563,11 @@ void Stash::_update_identification()
 {
     for (int i = items.size() - 1; i >= 0; i--)
     {
+        const iflags_t old_flags = items[i].flags;
         passive_id_item(items[i]);
         maybe_identify_base_type(items[i]);
+        if (items[i].flags != old_flags)
+            invalidate_search_text();
     }
 }
 
@@ -535,6 +576,8 @@ void Stash::add_item(const item_def &item, bool add_to_front)
     if (_is_rottable(item))
         StashTrack.update_corpses();
 
+    invalidate_search_text();
+
     if (add_to_front)
         items.insert(items.begin(), item);
     else
@@ -643,6 +686,7 @@ void Stash::load(reader& inf)
 
     // Zap out item vector, in case it's in use (however unlikely)
     items.clear();
+    invalidate_search_text();
     // Read in the items
     for (int i = 0; i < count; ++i)
     {
@@ -654,7 +698,7 @@ void Stash::load(reader& inf)
 }
 
 ShopInfo::ShopInfo(const shop_struct& shop_)
-    : shop(shop_)
+    : shop(shop_), search_text(), search_text_gen(-1)
 {
 }
 
@@ -724,21 +768,19 @@ vector<stash_search_result> ShopInfo::matches_search(
         }
     }
 
-    for (const item_def &item : shop.stock)
+    const vector<stash_search_text> &text = get_search_text();
+    for (int i = 0, count = shop.stock.size(); i < count; ++i)
     {
-        const string sname = shop_item_name(item);
-        const string ann   = stash_annotate_item(STASH_LUA_SEARCH_ANNOTATE,
-                                                 &item, true);
-
-        if (search.matches(prefix + " " + ann + " " + sname +
+        const stash_search_text &t = text[i];
+        if (search.matches(prefix + " " + t.annotation + " " + t.name +
                                                     " {" + shoptitle + "}")
-            || search.matches(shop_item_desc(item)))
+            || search.matches(t.artefact))
         {
             stash_search_result res;
             res.match_type = MATCH_ITEM;
-            res.match = sname;
-            res.primary_sort = item.name(DESC_QUALNAME);
-            res.item = item;
+            res.match = t.name;
+            res.primary_sort = t.qualname;
+            res.item = shop.stock[i];
             res.pos.pos = shop.pos;
             results.push_back(res);
         }
@@ -747,6 +789,31 @@ vector<stash_search_result> ShopInfo::matches_search(
     return results;
 }
 
+// As Stash::get_search_text(). Shops are replaced wholesale when their
+// stock changes, which resets the cache.
+const vector<stash_search_text> &ShopInfo::get_search_text() const
+{
+    if (search_text_gen == StashTrack.search_text_generation()
+        && search_text.size() == shop.stock.size())
+    {
+        return search_text;
+    }
+
+    search_text.clear();
+    for (const item_def &item : shop.stock)
+    {
+        stash_search_text t;
+        t.name = shop_item_name(item);
+        t.qualname = item.name(DESC_QUALNAME);
+        t.annotation = stash_annotate_item(STASH_LUA_SEARCH_ANNOTATE, &item,
+                                           true);
+        t.artefact = shop_item_desc(item);
+        search_text.push_back(t);
+    }
+    search_text_gen = StashTrack.search_text_generation();
+    return search_text;
+}
+
 void ShopInfo::write(FILE *f, bool identify) const
 {
     no_notes nx;
@@ -1440,6 +1507,7 @@ void StashTracker::search_stashes(string search_term)
 
     update_corpses();
     update_identification();
+    _update_search_text_state();
 
     if (search_term.empty())
     {
@@ -1858,6 +1926,52 @@ void StashTracker::update_identification()
         entry.second._update_identification();
 }
 
+// Has the user added any Lua autopickup functions? ch_force_autopickup()
+// itself is always defined by userbase.lua, but without any functions in
+// chk_force_autopickup it never has an opinion.
+static bool _autopickup_funcs_registered()
+{
+#ifdef CLUA_BINDINGS
+    lua_State *ls = clua.state();
+    if (!ls)
+        return false;
+    clua.pushglobal("chk_force_autopickup");
+    const bool registered = lua_istable(ls, -1) && lua_objlen(ls, -1) > 0;
+    lua_pop(ls, 1);
+    return registered;
+#else
+    return false;
+#endif
+}
+
+// Item names and annotations depend on which item types are known and which
+// are set to be autopicked up, and the {autopickup}, useless and forbidden
+// markers also on the player's god, species, form, mutations and spells. A
+// change to any of these invalidates the search text of every stash. A Lua
+// autopickup function can depend on anything, so while any are registered
+// every search starts afresh.
+void StashTracker::_update_search_text_state()
+{
+    uint32_t state =
+        hash32(&you.type_ids, sizeof(you.type_ids))
+        ^ hash32(&you.force_autopickup, sizeof(you.force_autopickup));
+    state = state * 31 + hash32(&you.mutation, sizeof(you.mutation));
+    state = state * 31 + hash32(&you.spell_library,
+                                sizeof(you.spell_library));
+    state = state * 31 + hash32(&you.spells, sizeof(you.spells));
+    state = state * 31 + you.religion;
+    state = state * 31 + you.species;
+    state = state * 31 + static_cast<uint32_t>(you.form);
+    state = state * 31 + you.hunger_state;
+
+    if (state != search_text_state || _autopickup_funcs_registered())
+    {
+        dprf("Rebuilding stash search text.");
+        search_text_state = state;
+        invalidate_search_text();
+    }
+}
+
 //////////////////////////////////////////////
 
 ST_ItemIterator::ST_ItemIterator()
@@ -18,6 +18,19 @@ class writer;
 class StashMenu;
 
 struct stash_search_result;
+
+// The text a stash search matches an item against. Building it means
+// naming the item and calling the Lua annotation hook, so it is cached
+// with the stash and only rebuilt when the pile or the search generation
+// (see StashTracker::invalidate_search_text()) changes.
+struct stash_search_text
+{
+    string name;        // stash_item_name(), or the shop listing
+    string qualname;    // DESC_QUALNAME, for sorting results
+    string annotation;  // STASH_LUA_SEARCH_ANNOTATE and friends
+    string artefact;    // chardump description, for dumpable artefacts
+};
+
 class Stash
 {
 public:
@@ -67,6 +80,8 @@ private:
     void _update_corpses(int rot_time);
     void _update_identification();
     void add_item(const item_def &item, bool add_to_front = false);
+    void invalidate_search_text() { search_text_gen = -1; }
+    const vector<stash_search_text> &get_search_text() const;
 
 private:
     bool verified;      // Is this correct to the best of our knowledge?
@@ -77,6 +92,10 @@ private:
 
     vector<item_def> items;
 
+    // Parallel to items; valid if search_text_gen is current.
+    mutable vector<stash_search_text> search_text;
+    mutable int search_text_gen;
+
     static bool are_items_same(const item_def &, const item_def &,
                                bool exact = false);
 
@@ -106,6 +125,11 @@ public:
 private:
     string shop_item_name(const item_def &it) const;
     string shop_item_desc(const item_def &it) const;
+    const vector<stash_search_text> &get_search_text() const;
+
+    // Parallel to shop.stock; valid if search_text_gen is current.
+    mutable vector<stash_search_text> search_text;
+    mutable int search_text_gen;
 
     friend class ST_ItemIterator;
 };
@@ -239,7 +263,8 @@ private:
 class StashTracker
 {
 public:
-    StashTracker() : levels(), last_corpse_update(0)
+    StashTracker() : levels(), last_corpse_update(0), search_text_gen(0),
+                     search_text_state(0)
     {
     }
 
@@ -279,7 +304,13 @@ public:
     void dump(const char *filename, bool identify = false) const;
 
     void remove_shop(const level_pos &pos);
+
+    // Forget the cached search text of every stash, e.g. because options
+    // or the Lua annotation hooks changed.
+    void invalidate_search_text() { ++search_text_gen; }
+    int search_text_generation() const { return search_text_gen; }
 private:
+    void _update_search_text_state();
     void get_matching_stashes(const base_pattern &search,
                               vector<stash_search_result> &results,
                               bool curr_lev = false) const;
@@ -298,6 +329,10 @@ private:
 
     int last_corpse_update;
 
+    int search_text_gen;
+    // Fingerprint of the global item knowledge that search text depends on.
+    uint32_t search_text_state;
+
     friend class ST_ItemIterator;
 };
 
@@ -39,7 +39,8 @@ game_state::game_state()
       obj_stat_gen(false), type(GAME_TYPE_NORMAL),
       last_type(GAME_TYPE_UNSPECIFIED), last_game_exit(game_exit::unknown),
       marked_as_won(false), arena_suspended(false),
-      generating_level(false), dump_maps(false), test(false), script(false),
+      generating_level(false), dump_maps(false), test(false),
+      test_list(false), test_perf_runs(0), script(false),
       build_db(false), tests_selected(),
 #ifdef DGAMELAUNCH
       throttle(true),
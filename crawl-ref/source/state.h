@@ -76,6 +76,7 @@ struct game_state
     bool dump_maps;         // Dump map Lua to stderr on fresh parse.
     bool test;              // Set if we want to run self-tests and exit.
     bool test_list;         // Show available tests and exit.
+    int test_perf_runs;     // Time each Lua test this many times, if > 0.
     bool script;            // Set if we want to run a Lua script and exit.
     bool build_db;          // Set if we want to rebuild the db and exit.
     vector<string> tests_selected; // Tests to be run.
@@ -8,7 +8,9 @@
 
 #include <climits>
 #include <map>
+#include <new>
 #include <string>
+#include <type_traits>
 #include <vector>
 
 class  reader;
@@ -243,7 +245,86 @@ protected:
     friend class CrawlVector;
 };
 
-class CrawlHashTable : public map<string, CrawlStoreValue>
+// Allocator for the nodes of CrawlHashTables. Props tables are built,
+// copied and torn down constantly along with the items and monsters that
+// own them, and all their nodes are the same size, so freed nodes are kept
+// on a free list (at most MAX_FREE_NODES per node type) for the next table
+// rather than going back to the heap.
+template <typename T>
+class store_node_allocator
+{
+public:
+    typedef T value_type;
+
+    store_node_allocator() {}
+    template <typename U>
+    store_node_allocator(const store_node_allocator<U> &) {}
+
+    T *allocate(size_t n)
+    {
+        if (n != 1)
+            return static_cast<T *>(::operator new(n * sizeof(T)));
+        if (!free_nodes)
+            return reinterpret_cast<T *>(new free_node);
+
+        free_node *node = free_nodes;
+        free_nodes = node->next;
+        --n_free_nodes;
+        return reinterpret_cast<T *>(node);
+    }
+
+    void deallocate(T *p, size_t n)
+    {
+        if (n != 1)
+        {
+            ::operator delete(p);
+            return;
+        }
+        free_node *node = reinterpret_cast<free_node *>(p);
+        if (n_free_nodes >= MAX_FREE_NODES)
+        {
+            delete node;
+            return;
+        }
+        node->next = free_nodes;
+        free_nodes = node;
+        ++n_free_nodes;
+    }
+
+private:
+    static const int MAX_FREE_NODES = 1024;
+
+    union free_node
+    {
+        free_node *next;
+        typename aligned_storage<sizeof(T), alignof(T)>::type value;
+    };
+    static free_node *free_nodes;
+    static int n_free_nodes;
+};
+
+template <typename T>
+typename store_node_allocator<T>::free_node *
+    store_node_allocator<T>::free_nodes = nullptr;
+
+template <typename T>
+int store_node_allocator<T>::n_free_nodes = 0;
+
+template <typename T, typename U>
+bool operator==(const store_node_allocator<T> &, const store_node_allocator<U> &)
+{
+    return true;
+}
+
+template <typename T, typename U>
+bool operator!=(const store_node_allocator<T> &, const store_node_allocator<U> &)
+{
+    return false;
+}
+
+class CrawlHashTable
+    : public map<string, CrawlStoreValue, less<string>,
+                 store_node_allocator<pair<const string, CrawlStoreValue>>>
 {
 public:
     friend class CrawlStoreValue;
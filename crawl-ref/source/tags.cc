@@ -59,8 +59,8 @@
 #include "mapmark.h"
 #include "misc.h"
 #include "mon-death.h"
+#include "mon-place.h"
 #if TAG_MAJOR_VERSION == 34
- #include "mon-place.h"
  #include "mon-poly.h"
  #include "mon-tentacle.h"
  #include "mon-util.h"
@@ -6096,6 +6096,8 @@ static void tag_read_level_items(reader &th)
         }
     }
 #endif
+
+    rebuild_free_item_slots();
 }
 
 void unmarshallMonster(reader &th, monster& m)
@@ -6709,6 +6711,8 @@ static void tag_read_level_monsters(reader &th)
         }
     }
 #endif
+
+    rebuild_free_monster_slots();
 }
 
 static void _debug_count_tiles()
@@ -81,6 +81,7 @@ bool targeter::affects_monster(const monster_info& mon)
 
 targeter_beam::targeter_beam(const actor *act, int r, zap_type zap,
                                int pow, int min_ex_rad, int max_ex_rad) :
+                               path_summarised(false),
                                min_expl_rad(min_ex_rad),
                                max_expl_rad(max_ex_rad),
                                range(r)
@@ -119,6 +120,7 @@ bool targeter_beam::set_aim(coord_def a)
     tempbeam.path_taken.clear();
     tempbeam.fire();
     path_taken = tempbeam.path_taken;
+    path_summarised = false;
 
     if (max_expl_rad > 0)
         set_explosion_aim(beam);
@@ -171,12 +173,12 @@ bool targeter_beam::can_affect_outside_range()
     return max_expl_rad > 0;
 }
 
-aff_type targeter_beam::is_affected(coord_def loc)
+void targeter_beam::summarise_path()
 {
-    bool on_path = false;
-    int visit_count = 0;
-    coord_def c;
-    aff_type current = AFF_YES;
+    path_visits.clear();
+    path_end = coord_def();
+
+    bool blocked = false;
     for (auto pc : path_taken)
     {
         if (cell_is_solid(pc)
@@ -186,24 +188,11 @@ aff_type targeter_beam::is_affected(coord_def loc)
             break;
         }
 
-        c = pc;
-        if (c == loc)
-        {
-            visit_count++;
-            if (max_expl_rad > 0)
-                on_path = true;
-            else if (cell_is_solid(pc))
-            {
-                bool res = beam.can_affect_wall(pc);
-                if (res)
-                    return current;
-                else
-                    return AFF_NO;
+        path_end = pc;
+        path_visit &visit = path_visits[pc];
+        if (!visit.count++)
+            visit.first = blocked ? AFF_MAYBE : AFF_YES;
 
-            }
-            else
-                continue;
-        }
         if (anyone_there(pc)
             && !penetrates_targets
             && !beam.ignores_monster(monster_at(pc)))
@@ -211,11 +200,24 @@ aff_type targeter_beam::is_affected(coord_def loc)
             // We assume an exploding spell will always stop here.
             if (max_expl_rad > 0)
                 break;
-            current = AFF_MAYBE;
+            blocked = true;
         }
     }
+
+    path_summarised = true;
+}
+
+aff_type targeter_beam::is_affected(coord_def loc)
+{
+    if (!path_summarised)
+        summarise_path();
+
+    const path_visit *visit = map_find(path_visits, loc);
+    const int visit_count = visit ? visit->count : 0;
+
     if (max_expl_rad > 0)
     {
+        const coord_def c = path_end;
         if ((loc - c).rdist() <= 9)
         {
             bool aff_wall = beam.can_affect_wall(loc);
@@ -232,8 +234,10 @@ aff_type targeter_beam::is_affected(coord_def loc)
             }
         }
         else
-            return on_path ? AFF_TRACER : AFF_NO;
+            return visit_count ? AFF_TRACER : AFF_NO;
     }
+    else if (visit_count && cell_is_solid(loc))
+        return beam.can_affect_wall(loc) ? visit->first : AFF_NO;
 
     return visit_count == 0 ? AFF_NO :
            visit_count == 1 ? AFF_YES :
@@ -297,6 +301,7 @@ bool targeter_unravelling::set_aim(coord_def a)
     tempbeam.path_taken.clear();
     tempbeam.fire();
     path_taken = tempbeam.path_taken;
+    path_summarised = false;
 
     bolt explosion_beam = beam;
     set_explosion_target(beam);
@@ -403,7 +408,8 @@ aff_type targeter_view::is_affected(coord_def loc)
 targeter_smite::targeter_smite(const actor* act, int ran,
                                  int exp_min, int exp_max, bool wall_ok,
                                  bool (*affects_pos_func)(const coord_def &)):
-    exp_range_min(exp_min), exp_range_max(exp_max), range(ran),
+    exp_range_min(exp_min), exp_range_max(exp_max),
+    checked_aim_valid(false), aim_checked(false), range(ran),
     affects_walls(wall_ok), affects_pos(affects_pos_func)
 {
     ASSERT(act);
@@ -463,7 +469,15 @@ bool targeter_smite::can_affect_walls()
 
 aff_type targeter_smite::is_affected(coord_def loc)
 {
-    if (!valid_aim(aim))
+    // This is asked for every cell in view, so don't redo the checks for
+    // each one.
+    if (!aim_checked || checked_aim != aim)
+    {
+        checked_aim = aim;
+        checked_aim_valid = valid_aim(aim);
+        aim_checked = true;
+    }
+    if (!checked_aim_valid)
         return AFF_NO;
 
     if (affects_pos && !affects_pos(loc))
@@ -56,6 +56,8 @@ public:
     virtual bool affects_monster(const monster_info& mon) override;
 protected:
     vector<coord_def> path_taken; // Path beam took.
+    // Must be cleared whenever path_taken changes.
+    bool path_summarised;
     void set_explosion_aim(bolt tempbeam);
     void set_explosion_target(bolt &tempbeam);
     int min_expl_rad, max_expl_rad;
@@ -63,6 +65,17 @@ protected:
 private:
     bool penetrates_targets;
     explosion_map exp_map_min, exp_map_max;
+
+    // What is_affected() needs to know about path_taken, gathered in one
+    // walk along it rather than one walk per cell asked about.
+    struct path_visit
+    {
+        int count;      // Times the (possibly truncated) path enters the cell.
+        aff_type first; // AFF_MAYBE if a monster is in the way before then.
+    };
+    map<coord_def, path_visit> path_visits;
+    coord_def path_end; // Where an explosion would go off.
+    void summarise_path();
 };
 
 class targeter_unravelling : public targeter_beam
@@ -105,6 +118,10 @@ public:
 protected:
     // assumes exp_map is valid only if >0, so let's keep it private
     int exp_range_min, exp_range_max;
+    // valid_aim(aim), remembered for is_affected().
+    coord_def checked_aim;
+    bool checked_aim_valid;
+    bool aim_checked;
     explosion_map exp_map_min, exp_map_max;
     int range;
 private:
@@ -144,7 +144,6 @@ mcache_manager::~mcache_manager()
 
 unsigned int mcache_manager::register_monster(const monster_info& minf)
 {
-    // TODO enne - is it worth it to search against all mcache entries?
     // TODO enne - pool mcache types to avoid too much alloc/dealloc?
 
     mcache_entry *entry;
@@ -169,6 +168,17 @@ unsigned int mcache_manager::register_monster(const monster_info& minf)
     else
         return 0;
 
+    // Monsters are registered again on every view update, and packs often
+    // look identical, so reuse an existing entry that draws the same thing.
+    // This also keeps the index stable, so webtiles doesn't resend the cell.
+    const mcache_key key = entry_key(*entry);
+    auto existing = m_keys.find(key);
+    if (existing != m_keys.end())
+    {
+        delete entry;
+        return TILEP_MCACHE_START + existing->second;
+    }
+
     tileidx_t idx = ~0;
 
     for (unsigned int i = 0; i < m_entries.size(); i++)
@@ -187,9 +197,36 @@ unsigned int mcache_manager::register_monster(const monster_info& minf)
         m_entries.push_back(entry);
     }
 
+    m_keys[key] = idx;
+
     return TILEP_MCACHE_START + idx;
 }
 
+mcache_manager::mcache_key mcache_manager::entry_key(const mcache_entry &entry)
+{
+    mcache_key key;
+
+    if (const dolls_data *doll = entry.doll())
+    {
+        key.push_back(TILEP_PART_MAX);
+        key.insert(key.end(), doll->parts, doll->parts + TILEP_PART_MAX);
+    }
+
+    tile_draw_info dinfo[mcache_entry::MAX_INFO_COUNT];
+    const int count = entry.info(&dinfo[0]);
+    key.push_back(count);
+    for (int i = 0; i < count; ++i)
+    {
+        key.push_back(dinfo[i].idx);
+        key.push_back(dinfo[i].ofs_x);
+        key.push_back(dinfo[i].ofs_y);
+    }
+
+    key.push_back(entry.transparent());
+
+    return key;
+}
+
 void mcache_manager::clear_nonref()
 {
     for (mcache_entry *&entry : m_entries)
@@ -197,6 +234,7 @@ void mcache_manager::clear_nonref()
         if (!entry || entry->ref_count() > 0)
             continue;
 
+        m_keys.erase(entry_key(*entry));
         delete entry;
         entry = nullptr;
     }
@@ -205,6 +243,7 @@ void mcache_manager::clear_nonref()
 void mcache_manager::clear_all()
 {
     deleteAll(m_entries);
+    m_keys.clear();
 }
 
 mcache_entry *mcache_manager::get(tileidx_t tile)
@@ -6,6 +6,7 @@
 #ifdef USE_TILE
 #pragma once
 
+#include <map>
 #include <vector>
 
 struct dolls_data;
@@ -73,7 +74,13 @@ public:
     bool empty() { return m_entries.empty(); }
 
 protected:
+    typedef vector<tileidx_t> mcache_key;
+    static mcache_key entry_key(const mcache_entry &entry);
+
     vector<mcache_entry*> m_entries;
+    // Entries that draw identically are shared; this maps what an entry
+    // draws to its index in m_entries.
+    map<mcache_key, unsigned int> m_keys;
 };
 
 // The global monster cache.
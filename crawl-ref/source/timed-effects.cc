@@ -7,6 +7,8 @@
 
 #include "timed-effects.h"
 
+#include <cmath>
+
 #include "abyss.h"
 #include "act-iter.h"
 #include "areas.h"
@@ -611,15 +613,16 @@ static void _monster_flee(monster *mon)
 static void _catchup_monster_move(monster* mon, int moves)
 {
     coord_def pos(mon->pos());
+    const coord_def target(mon->target);
+    const int dir = mons_is_retreating(*mon) ? -1 : 1;
 
-    // Dirt simple movement.
+    // Dirt simple movement: straight toward (or away from) the target
+    // until something is in the way. Nothing in the loop changes the
+    // monster, so its target and retreat status are read once.
     for (int i = 0; i < moves; ++i)
     {
-        coord_def inc(mon->target - pos);
-        inc = coord_def(sgn(inc.x), sgn(inc.y));
-
-        if (mons_is_retreating(*mon))
-            inc *= -1;
+        coord_def inc(target - pos);
+        inc = coord_def(sgn(inc.x), sgn(inc.y)) * dir;
 
         // Bounds check: don't let shifting monsters try to run off the
         // grid.
@@ -1248,11 +1251,28 @@ void timeout_terrain_changes(int duration, bool force)
 // Living breathing dungeon stuff.
 //
 
-static vector<coord_def> sfx_seeds;
+// Squares that give off smoke or mist. Rather than rolling for every one of
+// them each turn, each seed is filed on a timer wheel under the aut at which
+// it next fires, so a turn only touches the seeds that are due.
+static const int Base_Sfx_Chance = 5;     // % chance per BASELINE_DELAY
+static const int Sfx_Wheel_Size = 256;    // aut
+
+struct sfx_timer
+{
+    coord_def pos;
+    int due;
+};
+
+static vector<coord_def> sfx_seeds;       // not yet on the wheel
+static vector<sfx_timer> sfx_wheel[Sfx_Wheel_Size];
+static int sfx_clock = 0;
 
 void setup_environment_effects()
 {
     sfx_seeds.clear();
+    for (vector<sfx_timer> &slot : sfx_wheel)
+        slot.clear();
+    sfx_clock = 0;
 
     for (int x = X_BOUND_1; x <= X_BOUND_2; ++x)
     {
@@ -1286,40 +1306,63 @@ static void apply_environment_effect(const coord_def &c)
         check_place_cloud(CLOUD_MIST,        c, random_range(2, 5), 0);
 }
 
-static const int Base_Sfx_Chance = 5;
-void run_environment_effects()
+// How many aut until a seed next fires, if it has a Base_Sfx_Chance percent
+// chance of doing so every BASELINE_DELAY aut.
+static int _sfx_delay()
 {
-    if (!you.time_taken)
-        return;
-
-    dungeon_events.fire_event(DET_TURN_ELAPSED);
+    static const double per_aut =
+        1.0 - pow(1.0 - Base_Sfx_Chance / 100.0, 1.0 / BASELINE_DELAY);
+    return 1 + static_cast<int>(log1p(-random_real()) / log1p(-per_aut));
+}
 
-    // Each square in sfx_seeds has this chance of doing something special
-    // per turn.
-    const int sfx_chance = Base_Sfx_Chance * you.time_taken / 10;
-    const int nseeds = sfx_seeds.size();
+static void _schedule_sfx(const coord_def &c, int due)
+{
+    sfx_wheel[due % Sfx_Wheel_Size].push_back({c, due});
+}
 
-    // If there are a large number of seeds, speed things up by fudging the
-    // numbers.
-    if (nseeds > 50)
-    {
-        int nsels = div_rand_round(sfx_seeds.size() * sfx_chance, 100);
-        if (one_chance_in(5))
-            nsels += random2(nsels * 3);
+static void _run_sfx_wheel(int time_taken)
+{
+    // Seeds go on the wheel lazily, so that setting them up at level
+    // creation doesn't draw from the level generation RNG.
+    for (const coord_def &c : sfx_seeds)
+        _schedule_sfx(c, sfx_clock + _sfx_delay());
+    sfx_seeds.clear();
 
-        for (int i = 0; i < nsels; ++i)
-            apply_environment_effect(sfx_seeds[ random2(nseeds) ]);
-    }
-    else
+    const int now = sfx_clock + time_taken;
+    vector<coord_def> fired;
+    for (int t = sfx_clock + 1; t <= now && t <= sfx_clock + Sfx_Wheel_Size;
+         ++t)
     {
-        for (int i = 0; i < nseeds; ++i)
+        vector<sfx_timer> &slot = sfx_wheel[t % Sfx_Wheel_Size];
+        for (unsigned int i = 0; i < slot.size();)
         {
-            if (random2(100) >= sfx_chance)
+            if (slot[i].due > now)
+            {
+                ++i;
                 continue;
-
-            apply_environment_effect(sfx_seeds[i]);
+            }
+            fired.push_back(slot[i].pos);
+            slot[i] = slot.back();
+            slot.pop_back();
         }
     }
+    sfx_clock = now;
+
+    for (const coord_def &c : fired)
+    {
+        apply_environment_effect(c);
+        _schedule_sfx(c, now + _sfx_delay());
+    }
+}
+
+void run_environment_effects()
+{
+    if (!you.time_taken)
+        return;
+
+    dungeon_events.fire_event(DET_TURN_ELAPSED);
+
+    _run_sfx_wheel(you.time_taken);
 
     run_corruption_effects(you.time_taken);
     shoals_apply_tides(div_rand_round(you.time_taken, BASELINE_DELAY),
@@ -1490,6 +1490,9 @@ void viewwindow(bool show_updates, bool tiles_only, animation *a)
         if (flash_colour == BLACK)
             flash_colour = viewmap_flash_colour();
 
+        // Every cell is recomputed: elemental colours, animations and
+        // flashes can change a cell whose map knowledge hasn't. puttext()
+        // only sends the cells that came out different to the terminal.
         const coord_def tl = coord_def(1, 1);
         const coord_def br = crawl_view.viewsz;
         for (rectangle_iterator ri(tl, br); ri; ++ri)
@@ -866,6 +866,7 @@ static void _debug_acquirement_stats(FILE *ostat)
         return;
     }
     mitm[p].base_type = OBJ_UNASSIGNED;
+    release_item_slot(p);
 
     clear_messages();
     mpr("[a] Weapons [b] Armours   [c] Jewellery [d] Books");